@@ -9,10 +9,10 @@ set PIXI=1
 set DEBUG=0
 
 @rem List your source files here
-set SRC=Card.cpp Deck.cpp Player.cpp Main.cpp Game.cpp Hand.cpp Surface.cpp Tableau.cpp Options.cpp Stats.cpp Dimensions.cpp
+set SRC=Card.cpp Deck.cpp Player.cpp Main.cpp Game.cpp Hand.cpp Surface.cpp Tableau.cpp Options.cpp Stats.cpp Dimensions.cpp Engine.cpp HandView.cpp TableauView.cpp Game_Graphics.cpp Random.cpp Search.cpp Thread.cpp Sampler.cpp Solver.cpp Weights.cpp Trace.cpp Belief.cpp Refiner.cpp Extension.cpp DecisionCache.cpp Evaluator.cpp Compositor.cpp CardAtlas.cpp ImageCache.cpp GlyphAtlas.cpp
 
 @rem List the libraries needed
-set LIBS=-lSDL -lSDL_ttf -lSDL_image -lpdl
+set LIBS=-lSDL -lSDL_ttf -lSDL_image -lpdl -lpthread
 
 @rem Name your output executable
 set OUTFILE=..\pkg\SDLMille.elf
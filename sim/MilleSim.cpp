@@ -0,0 +1,371 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Extension.h"
+#include "Search.h"
+#include "Tuner.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*	millesim: plays computer-vs-computer games with no graphics and reports the results and
+	how fast the rules engine runs. Build it from this directory against the files in ../src
+	(see README). */
+
+using namespace _SDLMille;
+
+namespace
+{
+
+bool	SameText	(const char *Left, const char *Right)
+{
+	// Case-insensitive, since strcasecmp isn't available everywhere
+	while (*Left && (tolower(*Left) == tolower(*Right)))
+	{
+		++Left;
+		++Right;
+	}
+
+	return tolower(*Left) == tolower(*Right);
+}
+
+bool	ParseLevel	(const char *Text, Uint8 &Level)
+{
+	for (Uint8 i = 0; i < DIFFICULTY_LEVEL_COUNT; ++i)
+	{
+		char	Digit[2] = {(char) ('0' + i), 0};
+
+		if ((strcmp(Text, Digit) == 0) || SameText(Text, DIFFICULTY_TEXT[i]))
+		{
+			Level = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool	ParseSeed	(const char *Text, Uint64 &Seed)
+{
+	// Decimal only; strtoull isn't in C++98
+	Seed = 0;
+
+	for (const char *Digit = Text; *Digit; ++Digit)
+	{
+		if (!isdigit(*Digit))
+			return false;
+
+		Seed = Seed * 10 + (*Digit - '0');
+	}
+
+	return *Text != 0;
+}
+
+void	Report		(const Tournament &Results)
+{
+	double	Seconds = Results.GetMilliseconds() / 1000.0;
+	Uint32	TotalGames = 0, TotalHands = 0, TotalErrors = 0;
+
+	for (int i = 0; i < Results.GetPairingCount(); ++i)
+	{
+		const TournamentResult	&Result = Results.GetResult(i);
+		double					Rate, RateMargin, Average[2], AverageMargin[2];
+
+		Rate = Tournament::GetScoreRate(Result, RateMargin);
+		for (int j = 0; j < 2; ++j)
+			Average[j] = Tournament::GetAverageScore(Result, j, AverageMargin[j]);
+
+		printf("%s vs %s: %u games, W/D/L %u/%u/%u, score %.3f +/- %.3f\n",
+			DIFFICULTY_TEXT[Result.Policies[0]], DIFFICULTY_TEXT[Result.Policies[1]], Result.Games,
+			Result.Outcomes[OUTCOME_WON], Result.Outcomes[OUTCOME_DRAW], Result.Outcomes[OUTCOME_LOST],
+			Rate, RateMargin);
+		printf("    Average hand: %s %.1f +/- %.1f, %s %.1f +/- %.1f (%u hands)\n",
+			DIFFICULTY_TEXT[Result.Policies[0]], Average[0], AverageMargin[0],
+			DIFFICULTY_TEXT[Result.Policies[1]], Average[1], AverageMargin[1], Result.Hands);
+
+		TotalGames += Result.Games;
+		TotalHands += Result.Hands;
+		TotalErrors += Result.Errors;
+	}
+
+	// The two games of a pair share their cards, so they count as one sample
+	printf("(+/- gives 95%% intervals over seat-swapped pairs of games)\n\n");
+
+	for (int i = 0; i < Results.GetThreadCount(); ++i)
+	{
+		double	ThreadSeconds = Results.GetThreadMilliseconds(i) / 1000.0;
+
+		printf("Thread %d: %u games in %.2fs, %.1f games/sec\n", i, Results.GetThreadGames(i), ThreadSeconds,
+			(ThreadSeconds > 0) ? Results.GetThreadGames(i) / ThreadSeconds : 0.0);
+	}
+
+	if (Seconds <= 0)
+		Seconds = 0.001;
+
+	printf("Total: %u games, %u hands, %u errors in %.2fs, %.1f games/sec, %.1f hands/sec\n",
+		TotalGames, TotalHands, TotalErrors, Seconds, TotalGames / Seconds, TotalHands / Seconds);
+	printf("Seed: %llu (pass -s to replay)\n", (unsigned long long) Results.GetSeed());
+
+	if (Results.GetCache() != 0)
+	{
+		const DecisionCache	&Cache = *Results.GetCache();
+		Uint64				Lookups = Cache.GetLookups();
+		double				Speedup = Cache.GetSpeedup();
+
+		printf("Decision cache: %llu lookups, %.1f%% hits", (unsigned long long) Lookups,
+			(Lookups > 0) ? (100.0 * Cache.GetHits()) / Lookups : 0.0);
+
+		if (Speedup > 0)
+			printf(", decisions %.2fx as fast\n", Speedup);
+		else
+			printf(", too few decisions timed to tell the speedup\n");
+	}
+}
+
+bool	Tune		(const WeightTable &Initial, Uint8 Level, Uint32 Generations, Uint8 Size, Uint32 GameCount, Uint8 ThreadCount, Uint64 Seed, const char *OutputPath)
+{
+	Tuner	Weights;
+
+	printf("Tuning %s: %u generations of %u tables, %u games each against the default weights\n",
+		DIFFICULTY_TEXT[Level], Generations, Size, GameCount);
+
+	Weights.Start(Initial, Size, Level, Seed);
+
+	// Saved after every generation, so a long run can be stopped at any point
+	for (Uint32 i = 0; i < Generations; ++i)
+	{
+		if (!Weights.Step(GameCount, ThreadCount))
+		{
+			printf("Generation %u failed\n", i + 1);
+			return false;
+		}
+
+		printf("Generation %u: best so far from generation %u, margin %+.1f points a hand (%.2fs)\n", Weights.GetGeneration(),
+			Weights.GetBestGeneration(), Weights.GetBestScore(), Weights.GetMilliseconds() / 1000.0);
+
+		if (!Weights.GetBest().Save(OutputPath))
+		{
+			printf("Couldn't write %s\n", OutputPath);
+			return false;
+		}
+	}
+
+	printf("Best weights saved to %s\n", OutputPath);
+	printf("Seed: %llu (pass -s to replay)\n", (unsigned long long) Seed);
+
+	return true;
+}
+
+void	Usage		(const char *Name)
+{
+	printf("Usage: %s [-g games] [-a level] [-b level] [-r] [-s seed] [-t threads] [-p playouts] [-m ms]\n", Name);
+	printf("       [-k ms] [-w file] [-u generations] [-n tables] [-o file] [-d file] [-x file]\n");
+	printf("       [-c file] [-e file] [-l file]\n");
+	printf("  -g games    number of games per pairing (default 1000)\n");
+	printf("  -a level    first difficulty: 0-3 or Easy, Normal, Hard, Expert (default Normal)\n");
+	printf("  -b level    second difficulty (default Normal)\n");
+	printf("  -r          round-robin between every difficulty instead of -a against -b\n");
+	printf("  -s seed     replay the games of an earlier run (default: a fresh seed)\n");
+	printf("  -t threads  worker threads (default one per processor)\n");
+	printf("  -p playouts Expert's playouts per move (default %u)\n", SEARCH_DEFAULT_PLAYOUTS);
+	printf("  -m ms       Expert's time limit per move (default none)\n");
+	printf("  -k ms       thinking time per move for Hard and Expert, as the game gives them\n");
+	printf("              while it paces its moves (default 0, a fixed effort per move)\n");
+	printf("  -w file     weights for the first difficulty (default the built-in ones)\n");
+	printf("  -u gens     tune the first difficulty's weights for this many generations instead,\n");
+	printf("              playing -g games per table against the default weights\n");
+	printf("  -n tables   tables per generation when tuning (default 16, at most %u)\n", TUNER_POPULATION_MAX);
+	printf("  -o file     where tuning writes the best weights (default %s)\n", WEIGHT_FILE);
+	printf("  -d file     write a binary trace of the Normal and Hard decisions\n");
+	printf("  -x file     print a binary trace as text instead of playing\n");
+	printf("  -c file     share a cache of Hard's decisions between games, loaded from\n");
+	printf("              and saved back to file\n");
+	printf("  -e file     network Expert values positions with instead of playing them out\n");
+	printf("  -l file     add a training record for every move chosen to file\n");
+}
+
+}
+
+int	main	(int argc, char* argv[])
+{
+	bool		RoundRobin = false,
+				Weighted = false;
+	const char	*CachePath = 0,
+				*DumpPath = 0,
+				*EvaluatorPath = 0,
+				*RecordPath = 0,
+				*OutputPath = WEIGHT_FILE,
+				*TracePath = 0;
+	Uint32		GameCount = 1000,
+				Generations = 0,
+				SearchMilliseconds = 0,
+				SearchPlayouts = SEARCH_DEFAULT_PLAYOUTS,
+				ThinkTime = 0;
+	Uint8		Levels[PLAYER_COUNT] = {DIFFICULTY_NORMAL, DIFFICULTY_NORMAL},
+				PopulationSize = 16,
+				ThreadCount = Thread::GetProcessorCount();
+	WeightTable	Weights;
+	Uint64		Seed = Random::MakeSeed();
+	Tournament	Games;
+	DecisionCache	Cache;
+	PositionEvaluator	Evaluator;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool	Valid = (i + 1 < argc);
+
+		if (strcmp(argv[i], "-r") == 0)
+			RoundRobin = true;
+		else if (Valid && (strcmp(argv[i], "-g") == 0))
+			Valid = ((GameCount = strtoul(argv[++i], 0, 10)) > 0);
+		else if (Valid && (strcmp(argv[i], "-a") == 0))
+			Valid = ParseLevel(argv[++i], Levels[0]);
+		else if (Valid && (strcmp(argv[i], "-b") == 0))
+			Valid = ParseLevel(argv[++i], Levels[1]);
+		else if (Valid && (strcmp(argv[i], "-s") == 0))
+			Valid = ParseSeed(argv[++i], Seed);
+		else if (Valid && (strcmp(argv[i], "-p") == 0))
+			SearchPlayouts = strtoul(argv[++i], 0, 10);
+		else if (Valid && (strcmp(argv[i], "-m") == 0))
+			SearchMilliseconds = strtoul(argv[++i], 0, 10);
+		else if (Valid && (strcmp(argv[i], "-k") == 0))
+			ThinkTime = strtoul(argv[++i], 0, 10);
+		else if (Valid && (strcmp(argv[i], "-w") == 0))
+			Valid = Weighted = Weights.Load(argv[++i]);
+		else if (Valid && (strcmp(argv[i], "-u") == 0))
+			Valid = ((Generations = strtoul(argv[++i], 0, 10)) > 0);
+		else if (Valid && (strcmp(argv[i], "-n") == 0))
+		{
+			int	Count = atoi(argv[++i]);
+
+			Valid = (Count > 1) && (Count <= TUNER_POPULATION_MAX);
+			PopulationSize = Count;
+		}
+		else if (Valid && (strcmp(argv[i], "-o") == 0))
+			OutputPath = argv[++i];
+		else if (Valid && (strcmp(argv[i], "-d") == 0))
+			TracePath = argv[++i];
+		else if (Valid && (strcmp(argv[i], "-x") == 0))
+			DumpPath = argv[++i];
+		else if (Valid && (strcmp(argv[i], "-c") == 0))
+			CachePath = argv[++i];
+		else if (Valid && (strcmp(argv[i], "-e") == 0))
+			Valid = Evaluator.Load(EvaluatorPath = argv[++i]);
+		else if (Valid && (strcmp(argv[i], "-l") == 0))
+			RecordPath = argv[++i];
+		else if (Valid && (strcmp(argv[i], "-t") == 0))
+		{
+			int	Count = atoi(argv[++i]);
+
+			Valid = (Count > 0) && (Count < 256);
+			ThreadCount = Count;
+		}
+		else
+			Valid = false;
+
+		if (!Valid)
+		{
+			Usage(argv[0]);
+			return -1;
+		}
+	}
+
+	/*	With several games running at once, each Expert search and each weighing of an
+		extension runs on one thread. Otherwise they spread across the whole machine. */
+	Search::SetDefaults(SearchPlayouts, SearchMilliseconds, (ThreadCount > 1) ? 1 : 0);
+	ExtensionEvaluator::SetDefaultThreadCount((ThreadCount > 1) ? 1 : 0);
+
+	if (EvaluatorPath != 0)
+	{
+		Search::SetDefaultEvaluator(&Evaluator);
+		printf("Leaf evaluator: %s (%s)\n", EvaluatorPath, PositionEvaluator::GetKernelName());
+	}
+
+	if (DumpPath != 0)
+	{
+		FILE	*TraceFile = fopen(DumpPath, "rb");
+		bool	Dumped = DecisionTrace::Dump(TraceFile, stdout);
+
+		if (TraceFile != 0)
+			fclose(TraceFile);
+
+		return Dumped ? 0 : -1;
+	}
+
+	if (TracePath != 0)
+	{
+		#ifndef	TRACE_DECISIONS
+		printf("Built without TRACE_DECISIONS, so %s will be empty\n", TracePath);
+		#endif
+
+		Games.SetTracePath(TracePath);
+	}
+
+	if (Generations > 0)
+		return Tune(Weights, Levels[0], Generations, PopulationSize, GameCount, ThreadCount, Seed, OutputPath) ? 0 : -1;
+
+	if (RoundRobin)
+	{
+		for (Uint8 i = 0; i < DIFFICULTY_LEVEL_COUNT; ++i)
+			Games.AddPolicy(i);
+	}
+	else
+	{
+		Games.AddPolicy(Levels[0], Weighted ? &Weights : 0);
+		Games.AddPolicy(Levels[1]);
+	}
+
+	Games.SetThinkTime(ThinkTime);
+
+	// A missing cache file just means starting cold
+	if (CachePath != 0)
+	{
+		Cache.Load(CachePath);
+		Games.SetCache(&Cache);
+	}
+
+	if (RecordPath != 0)
+		Games.SetRecordPath(RecordPath);
+
+	if (!Games.Run(GameCount, ThreadCount, Seed))
+	{
+		if (RecordPath != 0)
+			printf("Couldn't write %s\n", RecordPath);
+
+		return -1;
+	}
+
+	Report(Games);
+
+	if (RecordPath != 0)
+		printf("Training records: %llu added to %s\n", (unsigned long long) Games.GetRecords(), RecordPath);
+
+	if ((CachePath != 0) && !Cache.Save(CachePath))
+		printf("Couldn't write %s\n", CachePath);
+
+	for (int i = 0; i < Games.GetPairingCount(); ++i)
+	{
+		if (Games.GetResult(i).Errors > 0)
+			return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Belief.h"
+
+namespace _SDLMille
+{
+
+		HandBelief::HandBelief		(void)
+{
+	Reset();
+}
+
+double	HandBelief::GetProbability	(Uint8 Value, const Uint8 *Unseen, Uint8 HandCount)	const
+{
+	/*	Unseen holds how many of each value the observer can't account for. Each card in the
+		hand is treated as an independent draw, weighted by likelihood, which is close enough
+		for seven cards and much cheaper than counting every possible hand. */
+	double	Total = 0,
+			Missing = 1,
+			Share;
+
+	if ((Value >= CARD_NULL_NULL) || (Unseen[Value] == 0))
+		return 0;
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Total += Unseen[i] * Likelihoods[i];
+
+	Share = (Unseen[Value] * Likelihoods[Value]) / Total;
+
+	for (int i = 0; i < HandCount; ++i)
+		Missing *= 1 - Share;
+
+	return 1 - Missing;
+}
+
+void	HandBelief::Relax			(void)
+{
+	// One card in the hand has been replaced by a fresh draw, which knows nothing of the past
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Likelihoods[i] += (BELIEF_CERTAIN - Likelihoods[i]) / HAND_SIZE;
+}
+
+void	HandBelief::Reset			(void)
+{
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Likelihoods[i] = BELIEF_CERTAIN;
+}
+
+}
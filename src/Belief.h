@@ -0,0 +1,70 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_BELIEF_H
+#define	_SDLMILLE_BELIEF_H
+
+#include "Hand.h"
+
+namespace _SDLMille
+{
+
+/*	How much to scale the likelihood of holding a card by for each kind of evidence, out of
+	256. Passing up a coup fourre is nearly conclusive; the others only lean one way, since a
+	player may have reasons to hold a card back. */
+
+const	Uint8	BELIEF_CERTAIN = 255,
+				BELIEF_DISCARDED = 40,		// Discarded while this card would have been playable
+				BELIEF_NO_COUP_FOURRE = 24,	// Qualified for a coup fourre with this safety, but didn't call it
+				BELIEF_NO_MILEAGE = 160,	// Rolling, and played something other than this mileage
+				BELIEF_UNREMEDIED = 64;		// Stopped, and played something other than this remedy
+
+/*	What a player's opponent can infer about the player's hand from the way they play.
+	Every card value has a likelihood, relative to the other unseen cards, of being in the
+	hand; evidence scales it down, and drawing fresh cards lets it recover. The probability
+	that the hand holds a value treats the hand as a weighted draw from the unseen cards. */
+
+class HandBelief
+{
+public:
+				HandBelief		(void);
+	Uint8		GetLikelihood	(Uint8 Value)				const;
+	double		GetProbability	(Uint8 Value, const Uint8 *Unseen, Uint8 HandCount)	const;
+	void		Relax			(void);
+	void		Reset			(void);
+	void		Weaken			(Uint8 Value, Uint8 Factor);
+private:
+	Uint8		Likelihoods[CARD_NULL_NULL];
+};
+
+inline	Uint8	HandBelief::GetLikelihood	(Uint8 Value)		const
+{
+	return (Value < CARD_NULL_NULL) ? Likelihoods[Value] : 0;
+}
+
+inline	void	HandBelief::Weaken			(Uint8 Value, Uint8 Factor)
+{
+	// Never all the way to zero; only seeing every copy rules a card out
+	if (Value < CARD_NULL_NULL)
+		Likelihoods[Value] = std::max(1, (Likelihoods[Value] * Factor) >> 8);
+}
+
+}
+
+#endif
@@ -22,6 +22,33 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 namespace _SDLMille
 {
 
+namespace
+{
+
+const	char	*CARD_FILES[CARD_NULL_NULL + 1][2] = {
+					{"gfx/hazard_accident.png", "gfx/hazard_accident.png"},
+					{"gfx/hazard_gas.png", "gfx/hazard_gas.png"},
+					{"gfx/hazard_flat.png", "gfx/hazard_flat.png"},
+					{"gfx/hazard_speed_limit.png", "gfx/hazard_speed_limit.png"},
+					{"gfx/hazard_stop.png", "gfx/hazard_stop.png"},
+					{"gfx/remedy_repair.png", "gfx/remedy_repair.png"},
+					{"gfx/remedy_fuel.png", "gfx/remedy_fuel.png"},
+					{"gfx/remedy_spare.png", "gfx/remedy_spare.png"},
+					{"gfx/remedy_end_limit.png", "gfx/remedy_end_limit.png"},
+					{"gfx/remedy_roll.png", "gfx/remedy_roll.png"},
+					{"gfx/safety_driving_ace.png", "gfx/safety_driving_ace_cf.png"},
+					{"gfx/safety_extra_tank.png", "gfx/safety_extra_tank_cf.png"},
+					{"gfx/safety_puncture_proof.png", "gfx/safety_puncture_proof_cf.png"},
+					{"gfx/safety_right_of_way.png", "gfx/safety_right_of_way_cf.png"},
+					{"gfx/mileage_25.png", "gfx/mileage_25.png"},
+					{"gfx/mileage_50.png", "gfx/mileage_50.png"},
+					{"gfx/mileage_75.png", "gfx/mileage_75.png"},
+					{"gfx/mileage_100.png", "gfx/mileage_100.png"},
+					{"gfx/mileage_200.png", "gfx/mileage_200.png"},
+					{"gfx/null_null.png", "gfx/null_null.png"}	};
+
+}
+
 
 /* Public methods */
 
@@ -76,120 +103,10 @@ bool			Card::Draw				(Deck * Source)
 		return false;
 }
 
-Uint8			Card::GetCardFromMileage	(int Mileage)
-{
-	Uint8 ReturnValue = 0xFF;
-
-	if ((Mileage >= 25) && (Mileage <= 200) && ((Mileage % 25) == 0))
-	{
-		if (Mileage == 200)
-			ReturnValue = CARD_MILEAGE_200;
-		else if (Mileage <= 100)
-			ReturnValue = MILEAGE_OFFSET + ((Mileage / 25) - 1);
-	}
-
-	return ReturnValue;
-}
-
 const char *	Card::GetFileFromValue		(Uint8 ArgValue, bool CoupFourre)
 {
-	switch (ArgValue)
-	{
-	case CARD_HAZARD_ACCIDENT:
-		return "gfx/hazard_accident.png";
-	case CARD_HAZARD_GAS:
-		return "gfx/hazard_gas.png";
-	case CARD_HAZARD_FLAT:
-		return "gfx/hazard_flat.png";
-	case CARD_HAZARD_SPEED_LIMIT:
-		return "gfx/hazard_speed_limit.png";
-	case CARD_HAZARD_STOP:
-		return "gfx/hazard_stop.png";
-	case CARD_REMEDY_REPAIR:
-		return "gfx/remedy_repair.png";
-	case CARD_REMEDY_FUEL:
-		return "gfx/remedy_fuel.png";
-	case CARD_REMEDY_SPARE:
-		return "gfx/remedy_spare.png";
-	case CARD_REMEDY_END_LIMIT:
-		return "gfx/remedy_end_limit.png";
-	case CARD_REMEDY_ROLL:
-		return "gfx/remedy_roll.png";
-	case CARD_MILEAGE_25:
-		return "gfx/mileage_25.png";
-	case CARD_MILEAGE_50:
-		return "gfx/mileage_50.png";
-	case CARD_MILEAGE_75:
-		return "gfx/mileage_75.png";
-	case CARD_MILEAGE_100:
-		return "gfx/mileage_100.png";
-	case CARD_MILEAGE_200:
-		return "gfx/mileage_200.png";
-	case CARD_SAFETY_DRIVING_ACE:
-		if (CoupFourre)
-			return "gfx/safety_driving_ace_cf.png";
-		else
-			return "gfx/safety_driving_ace.png";
-	case CARD_SAFETY_EXTRA_TANK:
-		if (CoupFourre)
-			return "gfx/safety_extra_tank_cf.png";
-		else
-			return "gfx/safety_extra_tank.png";
-	case CARD_SAFETY_PUNCTURE_PROOF:
-		if (CoupFourre)
-			return "gfx/safety_puncture_proof_cf.png";
-		else
-			return "gfx/safety_puncture_proof.png";
-	case CARD_SAFETY_RIGHT_OF_WAY:
-		if (CoupFourre)
-			return "gfx/safety_right_of_way_cf.png";
-		else
-			return "gfx/safety_right_of_way.png";
-	case CARD_NULL_NULL:
-	default:
-		return "gfx/null_null.png";
-	}
-}
-
-Uint8			Card::GetMatchingSafety	(Uint8 HazardValue)
-{
-	Uint8	RetVal = 0xFF;
-	if (GetTypeFromValue(HazardValue) == CARD_HAZARD)
-	{
-		RetVal = HazardValue + SAFETY_OFFSET;
-		if (HazardValue == CARD_HAZARD_STOP)
-			--RetVal;
-	}
-	
-	return RetVal;
-}
-
-Uint8			Card::GetMileValue		(Uint8 ArgValue)
-{
-	Uint8 MileValue = 0;
-
-	if (GetTypeFromValue(ArgValue) == CARD_MILEAGE)
-	{
-		MileValue = 25 * (ArgValue - CARD_SAFETY_RIGHT_OF_WAY);
-		if (ArgValue == CARD_MILEAGE_200)
-			MileValue += 75;
-	}
-
-	return MileValue;
-}
-
-Uint8			Card::GetTypeFromValue	(Uint8 V)
-{
-	if (V <= CARD_HAZARD_STOP)
-		return CARD_HAZARD;
-	if (V <= CARD_REMEDY_ROLL)
-		return CARD_REMEDY;
-	if (V <= CARD_SAFETY_RIGHT_OF_WAY)
-		return CARD_SAFETY;
-	if (V < CARD_NULL_NULL)
-		return CARD_MILEAGE;
-	
-	return CARD_NULL;
+	// Only safeties have a coup fourre image
+	return CARD_FILES[std::min(ArgValue, (Uint8) CARD_NULL_NULL)][CoupFourre ? 1 : 0];
 }
 
 bool			Card::Restore			(FILE *SaveFile)
@@ -21,6 +21,7 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #define	_SDLMILLE_CARD_H
 
 #include "Deck.h"
+#include <algorithm>
 
 namespace _SDLMille
 {
@@ -28,7 +29,46 @@ namespace _SDLMille
 const int	CARD_VALUE_INVALID	= 1000;
 
 const Uint8	SAFETY_OFFSET = 10, // Used to convert from an index to a value
-			MILEAGE_OFFSET = 14;
+			MILEAGE_OFFSET = 14,
+			MILEAGE_STEPS = 40;	// 25-mile steps in an extended trip
+
+/*	Card metadata by value, so lookups in the AI's inner loops are loads rather than chains
+	of comparisons. Each table has an extra entry for CARD_NULL_NULL, which also stands in for
+	any value past it. */
+
+const	Uint8	CARD_TYPES[CARD_NULL_NULL + 1] = {
+					CARD_HAZARD, CARD_HAZARD, CARD_HAZARD, CARD_HAZARD, CARD_HAZARD,
+					CARD_REMEDY, CARD_REMEDY, CARD_REMEDY, CARD_REMEDY, CARD_REMEDY,
+					CARD_SAFETY, CARD_SAFETY, CARD_SAFETY, CARD_SAFETY,
+					CARD_MILEAGE, CARD_MILEAGE, CARD_MILEAGE, CARD_MILEAGE, CARD_MILEAGE,
+					CARD_NULL	},
+				CARD_MILE_VALUES[CARD_NULL_NULL + 1] = {
+					0, 0, 0, 0, 0,
+					0, 0, 0, 0, 0,
+					0, 0, 0, 0,
+					25, 50, 75, 100, 200,
+					0	},
+				MATCHING_SAFETIES[CARD_NULL_NULL + 1] = {	// Stop and speed limit are both cured by right of way
+					CARD_SAFETY_DRIVING_ACE, CARD_SAFETY_EXTRA_TANK, CARD_SAFETY_PUNCTURE_PROOF, CARD_SAFETY_RIGHT_OF_WAY, CARD_SAFETY_RIGHT_OF_WAY,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF	},
+				FINISHING_CARDS[MILEAGE_STEPS + 1] = {		// The one card that covers a distance, by 25-mile steps
+					0xFF, CARD_MILEAGE_25, CARD_MILEAGE_50, CARD_MILEAGE_75, CARD_MILEAGE_100,
+					0xFF, 0xFF, 0xFF, CARD_MILEAGE_200, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+					0xFF	};
+
+const	char	CARD_CAPTIONS[CARD_SAFETY_RIGHT_OF_WAY + 1][20] = {
+					"Crash HAZARD", "Fuel HAZARD", "Tire HAZARD", "Speed HAZARD", "Stop HAZARD",
+					"Crash REMEDY", "Fuel REMEDY", "Tire REMEDY", "Speed REMEDY", "Roll REMEDY",
+					"Crash SAFETY", "Fuel SAFETY", "Tire SAFETY", "Right-of-way SAFETY"	};
 
 class Card
 {
@@ -55,11 +95,35 @@ private:
 			Uint8			Type;
 };
 
+inline	Uint8	Card::GetCardFromMileage	(int Mileage)
+{
+	// 0xFF if no single card covers the distance
+	if ((Mileage < 0) || (Mileage > MILEAGE_STEPS * 25) || ((Mileage % 25) != 0))
+		return 0xFF;
+
+	return FINISHING_CARDS[Mileage / 25];
+}
+
+inline	Uint8	Card::GetMatchingSafety	(Uint8 HazardValue)
+{
+	return MATCHING_SAFETIES[std::min(HazardValue, (Uint8) CARD_NULL_NULL)];
+}
+
+inline	Uint8	Card::GetMileValue		(Uint8 ArgValue)
+{
+	return CARD_MILE_VALUES[std::min(ArgValue, (Uint8) CARD_NULL_NULL)];
+}
+
 inline	Uint8	Card::GetType	(void)	const
 {
 	return Type;
 }
 
+inline	Uint8	Card::GetTypeFromValue	(Uint8 ArgValue)
+{
+	return CARD_TYPES[std::min(ArgValue, (Uint8) CARD_NULL_NULL)];
+}
+
 inline	Uint8	Card::GetValue	(void)	const
 {
 	return Value;
@@ -0,0 +1,142 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "CardAtlas.h"
+#include "Compositor.h"
+#include "Surface.h"
+
+namespace _SDLMille
+{
+
+SDL_Surface	*CardAtlas::Sheet = 0;
+SDL_Rect	CardAtlas::Rects[CARD_SPRITE_COUNT];
+Uint32		CardAtlas::Stamp = 0;
+
+/* Public methods */
+
+const char *	CardAtlas::GetFile		(Uint8 Sprite)
+{
+	if (Sprite < CARD_SPRITE_COUP_FOURRE)
+		return Card::GetFileFromValue(Sprite);
+	else if (Sprite < CARD_SPRITE_BACK)
+		return Card::GetFileFromValue(Sprite - CARD_SPRITE_COUP_FOURRE + SAFETY_OFFSET, true);
+	else if (Sprite == CARD_SPRITE_BACK)
+		return "gfx/card_bg.png";
+	else if (Sprite == CARD_SPRITE_SHADOW)
+		return "gfx/card_shadow.png";
+	else
+		return "gfx/card_shadow_cf.png";
+}
+
+Uint8			CardAtlas::GetSprite	(Uint8 Value, bool CoupFourre)
+{
+	// Only safeties have a coup fourre image
+	if (CoupFourre && (Card::GetTypeFromValue(Value) == CARD_SAFETY))
+		return Value - SAFETY_OFFSET + CARD_SPRITE_COUP_FOURRE;
+
+	return std::min(Value, (Uint8) CARD_NULL_NULL);
+}
+
+bool			CardAtlas::Load			(void)
+{
+	SDL_Surface	*Images[CARD_SPRITE_COUNT];
+	int			Height = 0,
+				RowHeight = 0,
+				Width = 0,
+				X = 0,
+				Y = 0;
+	bool		Success = true;
+
+	if (Sheet != 0)
+		return true;
+
+	for (Uint8 i = 0; i < CARD_SPRITE_COUNT; ++i)
+	{
+		Images[i] = Surface::Load(GetFile(i));
+
+		if (Images[i] == 0)
+		{
+			Success = false;
+			continue;
+		}
+
+		// Lay the images out left to right, starting a new row when one would run past the edge
+		if ((X > 0) && ((X + Images[i]->w) > CARD_ATLAS_WIDTH))
+		{
+			X = 0;
+			Y += RowHeight;
+			RowHeight = 0;
+		}
+
+		Rects[i].x = X;
+		Rects[i].y = Y;
+		Rects[i].w = Images[i]->w;
+		Rects[i].h = Images[i]->h;
+
+		X += Images[i]->w;
+		RowHeight = std::max(RowHeight, Images[i]->h);
+		Width = std::max(Width, X);
+		Height = std::max(Height, Y + RowHeight);
+	}
+
+	if (Success)
+	{
+		SDL_PixelFormat	*Format = Images[0]->format;
+
+		// Same format as the loaded images, so blits from the sheet take the same path theirs did
+		Sheet = SDL_CreateRGBSurface(SDL_SWSURFACE, Width, Height, Format->BitsPerPixel, Format->Rmask, Format->Gmask, Format->Bmask, Format->Amask);
+	}
+
+	for (Uint8 i = 0; i < CARD_SPRITE_COUNT; ++i)
+	{
+		if (Images[i] == 0)
+			continue;
+
+		if (Sheet != 0)
+		{
+			SDL_Rect	Cell = Rects[i];
+
+			// Without SDL_SRCALPHA the blit copies the alpha channel rather than blending with it
+			SDL_SetAlpha(Images[i], 0, SDL_ALPHA_OPAQUE);
+			SDL_BlitSurface(Images[i], 0, Sheet, &Cell);
+		}
+
+		SDL_FreeSurface(Images[i]);
+	}
+
+	if (Sheet == 0)
+		return false;
+
+	SDL_SetAlpha(Sheet, SDL_SRCALPHA, SDL_ALPHA_OPAQUE);
+	Stamp = Compositor::NewStamp();
+
+	return true;
+}
+
+void			CardAtlas::Unload		(void)
+{
+	if (Sheet != 0)
+	{
+		SDL_FreeSurface(Sheet);
+		Sheet = 0;
+	}
+}
+
+}
@@ -0,0 +1,87 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_CARD_ATLAS_H
+#define	_SDLMILLE_CARD_ATLAS_H
+
+#include <SDL.h>
+#include "Card.h"
+
+namespace _SDLMille
+{
+
+/*	Sprites past the card values: the coup fourre safeties, then the card back and the two
+	shadows. A card value is its own sprite. */
+
+const	Uint8	CARD_SPRITE_COUP_FOURRE = CARD_NULL_NULL + 1,
+				CARD_SPRITE_BACK = CARD_SPRITE_COUP_FOURRE + 4,
+				CARD_SPRITE_SHADOW = CARD_SPRITE_BACK + 1,
+				CARD_SPRITE_SHADOW_CF = CARD_SPRITE_SHADOW + 1,
+				CARD_SPRITE_COUNT = CARD_SPRITE_SHADOW_CF + 1;
+
+const	int		CARD_ATLAS_WIDTH = 1024;	// Sprites are packed in rows no wider than this
+
+/*	Every card image packed into one display format surface at startup. A Surface given a
+	sprite blits its cell of the shared sheet instead of loading and owning its own copy, so
+	the hand, the tableaux and the animations all draw from the same pixels.
+
+	If any image fails to load, Load returns false and sprites fall back to loading their
+	files one by one, as they did before the atlas. */
+
+class CardAtlas
+{
+public:
+	static	const char *	GetFile		(Uint8 Sprite);
+	static	const SDL_Rect &	GetRect		(Uint8 Sprite);
+	static	SDL_Surface *	GetSheet	(void);
+	static	Uint8			GetSprite	(Uint8 Value, bool CoupFourre = false);
+	static	Uint32			GetStamp	(void);
+	static	bool			IsLoaded	(void);
+	static	bool			Load		(void);
+	static	void			Unload		(void);
+private:
+	static	SDL_Surface		*Sheet;
+	static	SDL_Rect		Rects[CARD_SPRITE_COUNT];
+	static	Uint32			Stamp;
+};
+
+inline	const SDL_Rect &	CardAtlas::GetRect		(Uint8 Sprite)
+{
+	return Rects[std::min(Sprite, (Uint8) (CARD_SPRITE_COUNT - 1))];
+}
+
+inline	SDL_Surface *	CardAtlas::GetSheet		(void)
+{
+	return Sheet;
+}
+
+inline	Uint32			CardAtlas::GetStamp		(void)
+{
+	return Stamp;
+}
+
+inline	bool			CardAtlas::IsLoaded		(void)
+{
+	return (Sheet != 0);
+}
+
+}
+
+#endif
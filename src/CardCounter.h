@@ -0,0 +1,89 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_CARDCOUNTER_H
+#define	_SDLMILLE_CARDCOUNTER_H
+
+#include "Deck.h"
+
+namespace _SDLMille
+{
+
+/*	How many cards of each value are in a group, kept up to date one card at a time so a
+	count never needs a search. Hand keeps one for the cards it holds, which is what the
+	AI's card-counting queries in Engine read. */
+
+class CardCounter
+{
+public:
+				CardCounter		(void);
+	void		Add				(Uint8 Value);
+	void		Clear			(void);
+	Uint8		Get				(Uint8 Value)				const;
+	Uint8		GetTotal		(void)						const;
+	void		Remove			(Uint8 Value);
+private:
+	Uint8		Counts[CARD_NULL_NULL],
+				Total;
+};
+
+inline			CardCounter::CardCounter	(void)
+{
+	Clear();
+}
+
+inline	void	CardCounter::Add		(Uint8 Value)
+{
+	if (Value < CARD_NULL_NULL)
+	{
+		++Counts[Value];
+		++Total;
+	}
+}
+
+inline	void	CardCounter::Clear		(void)
+{
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Counts[i] = 0;
+
+	Total = 0;
+}
+
+inline	Uint8	CardCounter::Get		(Uint8 Value)			const
+{
+	return (Value < CARD_NULL_NULL) ? Counts[Value] : 0;
+}
+
+inline	Uint8	CardCounter::GetTotal	(void)					const
+{
+	return Total;
+}
+
+inline	void	CardCounter::Remove		(Uint8 Value)
+{
+	if ((Value < CARD_NULL_NULL) && (Counts[Value] > 0))
+	{
+		--Counts[Value];
+		--Total;
+	}
+}
+
+}
+
+#endif
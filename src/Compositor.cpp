@@ -0,0 +1,329 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Compositor.h"
+#include <algorithm>
+
+namespace _SDLMille
+{
+
+std::vector<Compositor::Draw>	Compositor::Frame,
+								Compositor::Previous;
+std::vector<SDL_Rect>	Compositor::Damage;
+SDL_Surface	*Compositor::Screen = 0;
+int			Compositor::ScreenHeight = 0,
+			Compositor::ScreenWidth = 0;
+Uint32		Compositor::NextStamp = 0;
+bool		Compositor::Recording = false,
+			Compositor::Whole = true;
+
+/* Public methods */
+
+bool	Compositor::Begin		(SDL_Surface *NewScreen)
+{
+	if ((NewScreen == 0) || (NewScreen->flags & SDL_DOUBLEBUF))
+		return false;
+
+	// A new or resized screen has nothing on it worth keeping
+	if ((NewScreen != Screen) || (NewScreen->w != ScreenWidth) || (NewScreen->h != ScreenHeight))
+	{
+		Screen = NewScreen;
+		ScreenHeight = NewScreen->h;
+		ScreenWidth = NewScreen->w;
+		Whole = true;
+	}
+
+	Frame.clear();
+	Recording = true;
+
+	return true;
+}
+
+void	Compositor::End			(void)
+{
+	std::vector<Draw>	Sorted;
+
+	if (!Recording)
+		return;
+
+	Recording = false;
+	Damage.clear();
+
+	// Previous is kept sorted, so one pass over both finds the draws that differ
+	Sorted = Frame;
+	std::sort(Sorted.begin(), Sorted.end(), Before);
+
+	if (Whole)
+	{
+		SDL_Rect	All = {0, 0, (Uint16) ScreenWidth, (Uint16) ScreenHeight};
+
+		Damage.push_back(All);
+		Whole = false;
+	}
+	else
+	{
+		size_t	i = 0, j = 0;
+
+		while ((i < Sorted.size()) || (j < Previous.size()))
+		{
+			if ((j == Previous.size()) || ((i < Sorted.size()) && Before(Sorted[i], Previous[j])))
+				AddDamage(Sorted[i++].Area);
+			else if ((i == Sorted.size()) || Before(Previous[j], Sorted[i]))
+				AddDamage(Previous[j++].Area);
+			else
+			{
+				++i;
+				++j;
+			}
+		}
+
+		MergeDamage();
+	}
+
+	// Replay the frame once per damaged rectangle, clipped to it
+	for (size_t i = 0; i < Damage.size(); ++i)
+	{
+		const SDL_Rect	&Bounds = Damage[i];
+
+		SDL_SetClipRect(Screen, &Damage[i]);
+
+		for (size_t j = 0; j < Frame.size(); ++j)
+		{
+			SDL_Rect	Area = Frame[j].Area,
+						Part = Frame[j].Part;
+
+			if ((Area.x >= Bounds.x + Bounds.w) || (Area.x + Area.w <= Bounds.x) || (Area.y >= Bounds.y + Bounds.h) || (Area.y + Area.h <= Bounds.y))
+				continue;
+
+			if (Frame[j].Source != 0)
+				SDL_BlitSurface(Frame[j].Source, &Part, Screen, &Area);
+			else
+				SDL_FillRect(Screen, &Area, Frame[j].Stamp);
+		}
+	}
+
+	if (!Damage.empty())
+	{
+		SDL_SetClipRect(Screen, 0);
+		Push(Screen, &Damage[0], (int) Damage.size());
+	}
+
+	Previous.swap(Sorted);
+}
+
+void	Compositor::Invalidate	(void)
+{
+	// For when something drew on the screen behind our back
+	Whole = true;
+}
+
+Uint32	Compositor::NewStamp	(void)
+{
+	return ++NextStamp;
+}
+
+void	Compositor::Push		(SDL_Surface *Target, const SDL_Rect *Rects, int Count)
+{
+	std::vector<SDL_Rect>	Clipped;
+
+	if (Target == 0)
+		return;
+
+	// SDL_UpdateRects wants every rectangle inside the screen
+	for (int i = 0; i < Count; ++i)
+	{
+		int	Left = std::max((int) Rects[i].x, 0),
+			Top = std::max((int) Rects[i].y, 0),
+			Right = std::min(Rects[i].x + Rects[i].w, Target->w),
+			Bottom = std::min(Rects[i].y + Rects[i].h, Target->h);
+
+		if ((Right > Left) && (Bottom > Top))
+		{
+			SDL_Rect	Area = {(Sint16) Left, (Sint16) Top, (Uint16) (Right - Left), (Uint16) (Bottom - Top)};
+
+			Clipped.push_back(Area);
+		}
+	}
+
+	if (!Clipped.empty())
+		SDL_UpdateRects(Target, (int) Clipped.size(), &Clipped[0]);
+}
+
+bool	Compositor::Record		(SDL_Surface *Destination, SDL_Surface *Source, Uint32 Stamp, const SDL_Rect *Part, int X, int Y)
+{
+	Draw	Entry;
+	int		Left = 0,
+			Top = 0,
+			Right,
+			Bottom;
+
+	if (!Recording || (Destination != Screen) || (Source == 0))
+		return false;
+
+	Right = Source->w;
+	Bottom = Source->h;
+
+	// Trim the part to the source, moving the destination the way SDL_BlitSurface would
+	if (Part != 0)
+	{
+		Left = std::max((int) Part->x, 0);
+		Top = std::max((int) Part->y, 0);
+		Right = std::min(Part->x + Part->w, Right);
+		Bottom = std::min(Part->y + Part->h, Bottom);
+		X += Left - Part->x;
+		Y += Top - Part->y;
+	}
+
+	if ((Right <= Left) || (Bottom <= Top))
+		return true;
+
+	Entry.Source = Source;
+	Entry.Stamp = Stamp;
+	Entry.Part.x = Left;
+	Entry.Part.y = Top;
+	Entry.Part.w = Right - Left;
+	Entry.Part.h = Bottom - Top;
+	Entry.Area.x = X;
+	Entry.Area.y = Y;
+	Entry.Area.w = Entry.Part.w;
+	Entry.Area.h = Entry.Part.h;
+
+	Frame.push_back(Entry);
+
+	return true;
+}
+
+bool	Compositor::Record		(SDL_Surface *Destination, const SDL_Rect &Area, Uint32 Color)
+{
+	Draw	Entry;
+
+	if (!Recording || (Destination != Screen))
+		return false;
+
+	Entry.Source = 0;
+	Entry.Stamp = Color;
+	Entry.Area = Area;
+	Entry.Part = Area;
+
+	Frame.push_back(Entry);
+
+	return true;
+}
+
+/* Private methods */
+
+void	Compositor::AddDamage	(const SDL_Rect &Area)
+{
+	SDL_Rect	Clipped = Area;
+
+	if (Clip(Clipped))
+		Damage.push_back(Clipped);
+}
+
+bool	Compositor::Before		(const Draw &Left, const Draw &Right)
+{
+	// Fills first, then by stamp, then by where they land
+	if ((Left.Source == 0) != (Right.Source == 0))
+		return Left.Source == 0;
+	if (Left.Stamp != Right.Stamp)
+		return Left.Stamp < Right.Stamp;
+	if (Left.Area.x != Right.Area.x)
+		return Left.Area.x < Right.Area.x;
+	if (Left.Area.y != Right.Area.y)
+		return Left.Area.y < Right.Area.y;
+	if (Left.Area.w != Right.Area.w)
+		return Left.Area.w < Right.Area.w;
+	if (Left.Area.h != Right.Area.h)
+		return Left.Area.h < Right.Area.h;
+	if (Left.Part.x != Right.Part.x)
+		return Left.Part.x < Right.Part.x;
+
+	return Left.Part.y < Right.Part.y;
+}
+
+bool	Compositor::Clip		(SDL_Rect &Area)
+{
+	int	Left = std::max((int) Area.x, 0),
+		Top = std::max((int) Area.y, 0),
+		Right = std::min(Area.x + Area.w, ScreenWidth),
+		Bottom = std::min(Area.y + Area.h, ScreenHeight);
+
+	if ((Right <= Left) || (Bottom <= Top))
+		return false;
+
+	Area.x = Left;
+	Area.y = Top;
+	Area.w = Right - Left;
+	Area.h = Bottom - Top;
+
+	return true;
+}
+
+void	Compositor::MergeDamage	(void)
+{
+	bool	Merged = true;
+	int		Total = 0;
+
+	// Overlapping or touching rectangles become their union, until none overlap
+	while (Merged)
+	{
+		Merged = false;
+
+		for (size_t i = 0; i < Damage.size(); ++i)
+		{
+			for (size_t j = i + 1; j < Damage.size(); ++j)
+			{
+				SDL_Rect	&First = Damage[i],
+							&Second = Damage[j];
+
+				if ((First.x > Second.x + Second.w) || (Second.x > First.x + First.w) || (First.y > Second.y + Second.h) || (Second.y > First.y + First.h))
+					continue;
+
+				int	Left = std::min(First.x, Second.x),
+					Top = std::min(First.y, Second.y),
+					Right = std::max(First.x + First.w, Second.x + Second.w),
+					Bottom = std::max(First.y + First.h, Second.y + Second.h);
+
+				First.x = Left;
+				First.y = Top;
+				First.w = Right - Left;
+				First.h = Bottom - Top;
+
+				Damage.erase(Damage.begin() + j);
+				--j;
+				Merged = true;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < Damage.size(); ++i)
+		Total += Damage[i].w * Damage[i].h;
+
+	// Many small updates, or most of the screen, go out cheaper as one
+	if ((Damage.size() > COMPOSITOR_DAMAGE_MAX) || (Total * 4 > ScreenWidth * ScreenHeight * 3))
+	{
+		SDL_Rect	All = {0, 0, (Uint16) ScreenWidth, (Uint16) ScreenHeight};
+
+		Damage.clear();
+		Damage.push_back(All);
+	}
+}
+
+}
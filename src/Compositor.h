@@ -0,0 +1,81 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_COMPOSITOR_H
+#define	_SDLMILLE_COMPOSITOR_H
+
+#include <SDL.h>
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	Uint32	COMPOSITOR_DAMAGE_MAX = 24;	// Past this many separate rectangles, update the whole screen
+
+/*	Puts only what changed on the screen. Between Begin and End, every blit and fill aimed at
+	the screen is recorded instead of drawn. End compares the recording with the previous
+	frame's: a draw found in one and not the other damages the rectangle it covers, whether
+	a card was played, a surface was given new text, or something moved. Each damaged
+	rectangle is then redrawn by replaying the whole frame clipped to it, so overlaps layer
+	the same as a full redraw would, and only those rectangles go out with SDL_UpdateRects.
+
+	Draws are told apart by the stamp a Surface takes each time its image changes, so a
+	surface drawn in the same place with the same image costs nothing to re-record. A double
+	buffered screen has to be redrawn and flipped whole, so Begin refuses it and the caller
+	draws as before. */
+
+class Compositor
+{
+public:
+	static	bool	Begin		(SDL_Surface *NewScreen);
+	static	void	End			(void);
+	static	void	Invalidate	(void);
+	static	Uint32	NewStamp	(void);
+	static	void	Push		(SDL_Surface *Target, const SDL_Rect *Rects, int Count);
+	static	bool	Record		(SDL_Surface *Destination, SDL_Surface *Source, Uint32 Stamp, const SDL_Rect *Part, int X, int Y);
+	static	bool	Record		(SDL_Surface *Destination, const SDL_Rect &Area, Uint32 Color);
+private:
+	struct Draw
+	{
+		SDL_Surface	*Source;	// 0 for a fill
+		SDL_Rect	Area,		// Where it lands on the screen
+					Part;		// What part of the source it takes
+		Uint32		Stamp;		// The source's stamp, or the fill colour
+	};
+
+	static	void	AddDamage	(const SDL_Rect &Area);
+	static	bool	Before		(const Draw &Left, const Draw &Right);
+	static	bool	Clip		(SDL_Rect &Area);
+	static	void	MergeDamage	(void);
+
+	static	std::vector<Draw>		Frame,
+									Previous;
+	static	std::vector<SDL_Rect>	Damage;
+	static	SDL_Surface	*Screen;
+	static	int			ScreenHeight,
+						ScreenWidth;
+	static	Uint32		NextStamp;
+	static	bool		Recording,
+						Whole;		// Redraw everything at the next End
+};
+
+}
+
+#endif
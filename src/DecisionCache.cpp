@@ -0,0 +1,252 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "DecisionCache.h"
+#include "Random.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace _SDLMille
+{
+
+namespace
+{
+
+const	char	CACHE_MAGIC[4] = {'M', 'D', 'C', '2'};	// Changes with the key, so files of older keys are turned away
+const	Uint64	CACHE_DECISION_MASK = 0xFF;
+
+}
+
+		DecisionCache::DecisionCache	(Uint32 NewCapacity)
+{
+	Uint32	Capacity = 1;
+
+	// Round down to a power of two, so a slot is just some bits of the hash
+	while ((Capacity << 1) <= NewCapacity)
+		Capacity <<= 1;
+
+	Entries.resize(Capacity);
+	Clear();
+}
+
+void	DecisionCache::Clear			(void)
+{
+	for (Uint32 i = 0; i < Entries.size(); ++i)
+		Entries[i] = 0;
+
+	for (Uint32 i = 0; i < DECISION_CACHE_STRIPES; ++i)
+	{
+		Stripes[i].Hits = 0;
+		Stripes[i].Lookups = 0;
+	}
+
+	ComputeTime = 0;
+	HitSamples = 0;
+	HitTime = 0;
+	MissSamples = 0;
+	MissTime = 0;
+}
+
+void	DecisionCache::AddSample		(bool Hit, Uint32 Microseconds, Uint32 ComputeMicroseconds)
+{
+	// Microseconds is the whole decision, key and all; ComputeMicroseconds just the deciding on a miss
+	SampleLock.Lock();
+
+	if (Hit)
+	{
+		++HitSamples;
+		HitTime += Microseconds;
+	}
+	else
+	{
+		++MissSamples;
+		MissTime += Microseconds;
+		ComputeTime += ComputeMicroseconds;
+	}
+
+	SampleLock.Unlock();
+}
+
+bool	DecisionCache::Find			(const DecisionKey &Key, Uint8 &Decision)
+{
+	Uint64	Check = GetCheck(Key);
+	Uint32	Slot = GetSlot(Check);
+	Stripe	&Guard = Stripes[Slot & (DECISION_CACHE_STRIPES - 1)];
+	Uint64	Stored;
+
+	Guard.Lock.Lock();
+
+	Stored = Entries[Slot];
+	if ((Stored & ~CACHE_DECISION_MASK) == Check)
+		++Guard.Hits;
+	++Guard.Lookups;
+
+	Guard.Lock.Unlock();
+
+	if ((Stored & ~CACHE_DECISION_MASK) != Check)
+		return false;
+
+	Decision = (Uint8) (Stored & CACHE_DECISION_MASK);
+
+	return true;
+}
+
+Uint64	DecisionCache::GetHits		(void)						const
+{
+	// Only meaningful once the threads sharing the cache are done with it
+	Uint64	Hits = 0;
+
+	for (Uint32 i = 0; i < DECISION_CACHE_STRIPES; ++i)
+		Hits += Stripes[i].Hits;
+
+	return Hits;
+}
+
+Uint64	DecisionCache::GetLookups	(void)						const
+{
+	Uint64	Lookups = 0;
+
+	for (Uint32 i = 0; i < DECISION_CACHE_STRIPES; ++i)
+		Lookups += Stripes[i].Lookups;
+
+	return Lookups;
+}
+
+double	DecisionCache::GetSpeedup	(void)						const
+{
+	/*	Without the cache, every lookup would have cost what an average sampled miss spent
+		working out its decision. With it, hits and misses each cost what their samples took
+		on average, in the proportions they happened. 0 if there aren't enough samples, or
+		none of a kind that happened. */
+	Uint64	Hits = GetHits(),
+			Lookups = GetLookups();
+	double	With;
+
+	if (((HitSamples + MissSamples) < DECISION_CACHE_SAMPLES_MIN) || (MissSamples == 0) || ((Hits > 0) && (HitSamples == 0)))
+		return 0;
+
+	With = (double) MissTime / MissSamples * (Lookups - Hits);
+
+	if (Hits > 0)
+		With += (double) HitTime / HitSamples * Hits;
+
+	if (With <= 0)
+		return 0;
+
+	return (double) ComputeTime / MissSamples * Lookups / With;
+}
+
+bool	DecisionCache::Load			(const char *Path)
+{
+	// Adds to what is already cached; the counts are left alone
+	FILE	*CacheFile = fopen(Path, "rb");
+	char	Magic[sizeof(CACHE_MAGIC)];
+	Uint8	Bytes[8];
+	bool	Loaded;
+
+	if (CacheFile == 0)
+		return false;
+
+	Loaded = (fread(Magic, 1, sizeof(Magic), CacheFile) == sizeof(Magic)) && (memcmp(Magic, CACHE_MAGIC, sizeof(Magic)) == 0);
+
+	while (Loaded && (fread(Bytes, 1, sizeof(Bytes), CacheFile) == sizeof(Bytes)))
+	{
+		Uint64	Entry = 0;
+
+		for (int i = 7; i >= 0; --i)
+			Entry = (Entry << 8) | Bytes[i];
+
+		if (Entry != 0)
+			Entries[GetSlot(Entry)] = Entry;
+	}
+
+	fclose(CacheFile);
+
+	return Loaded;
+}
+
+bool	DecisionCache::Save			(const char *Path)			const
+{
+	FILE	*CacheFile = fopen(Path, "wb");
+	bool	Saved;
+
+	if (CacheFile == 0)
+		return false;
+
+	Saved = (fwrite(CACHE_MAGIC, 1, sizeof(CACHE_MAGIC), CacheFile) == sizeof(CACHE_MAGIC));
+
+	for (Uint32 i = 0; Saved && (i < Entries.size()); ++i)
+	{
+		Uint8	Bytes[8];
+
+		if (Entries[i] == 0)
+			continue;
+
+		for (int j = 0; j < 8; ++j)
+			Bytes[j] = (Uint8) (Entries[i] >> (j * 8));
+
+		Saved = (fwrite(Bytes, 1, sizeof(Bytes), CacheFile) == sizeof(Bytes));
+	}
+
+	if (fclose(CacheFile) != 0)
+		Saved = false;
+
+	return Saved;
+}
+
+void	DecisionCache::Store			(const DecisionKey &Key, Uint8 Decision)
+{
+	Uint64	Check = GetCheck(Key);
+	Uint32	Slot = GetSlot(Check);
+	Stripe	&Guard = Stripes[Slot & (DECISION_CACHE_STRIPES - 1)];
+
+	Guard.Lock.Lock();
+
+	Entries[Slot] = Check | Decision;
+
+	Guard.Lock.Unlock();
+}
+
+/* Private methods */
+
+Uint64	DecisionCache::GetCheck		(const DecisionKey &Key)
+{
+	// The key four bytes at a time, then scrambled; the low byte is left for the decision
+	Uint64	Hash = 0;
+
+	for (int i = 0; i < DECISION_KEY_SIZE; i += 4)
+	{
+		Hash ^= Key.Bytes[i] | (Key.Bytes[i + 1] << 8) | (Key.Bytes[i + 2] << 16) | ((Uint32) Key.Bytes[i + 3] << 24);
+		Hash = Random::Mix(Hash);
+	}
+
+	Hash &= ~CACHE_DECISION_MASK;
+
+	// A zero entry is an empty one
+	return (Hash != 0) ? Hash : (CACHE_DECISION_MASK + 1);
+}
+
+Uint32	DecisionCache::GetSlot		(Uint64 Entry)				const
+{
+	// From the hash bits, so a saved entry finds its slot again in a table of any size
+	return (Uint32) (Entry >> 8) & (Entries.size() - 1);
+}
+
+}
@@ -0,0 +1,111 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+
+#ifndef _SDLMILLE_DECISIONCACHE_H
+#define	_SDLMILLE_DECISIONCACHE_H
+
+#include "Thread.h"
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	Uint8	DECISION_KEY_SIZE = 52,
+				DECISION_DISCARD = 0x80;		// Set in a decision that discards its card instead of playing it
+const	Uint32	DECISION_CACHE_SIZE = 1 << 18,	// Default entries; must be a power of two
+				DECISION_CACHE_STRIPES = 64;	// Locks the entries are shared out between
+const	Uint8	DECISION_CACHE_SAMPLING = 64;	// One decision in this many is timed; a power of two
+const	Uint32	DECISION_CACHE_SAMPLES_MIN = 100;	// Timed decisions needed before there is a speedup to report
+
+/*	Everything ComputerSmartMove looks at, boiled down so that two positions it can't tell
+	apart pack to the same bytes: the hand as a sorted multiset, both tableaux, the exposed
+	card counts, the cards left, what it believes about the opponent's hand, and a
+	fingerprint of the weights. Engine fills it in. */
+
+struct DecisionKey
+{
+	Uint8		Bytes[DECISION_KEY_SIZE];
+};
+
+/*	A fixed-size table from DecisionKeys to the card ComputerSmartMove chose, as a card
+	value with DECISION_DISCARD set for a discard, or MOVE_NONE. Like the solver's table, it
+	trusts a 64-bit hash of the key: each entry is one word, the top 56 bits of the hash
+	with the decision in the low byte, so the table stays small enough to sit in cache. A key
+	hashes to one entry, which a newer decision simply replaces, so the table never grows.
+	Entries are guarded by striped locks, so every thread in a run can share one cache.
+
+	The cache also keeps score: how often it was asked and how often it knew. Callers time a
+	sample of their decisions, hits and misses, and from how long those took against how long
+	working them out took, GetSpeedup estimates how much faster decisions were overall.
+
+	A saved cache is the 4 bytes "MDC1" followed by each entry in use, as a little-endian
+	64-bit word. */
+
+class DecisionCache
+{
+public:
+	explicit	DecisionCache	(Uint32 NewCapacity = DECISION_CACHE_SIZE);
+	void		Clear			(void);
+	void		AddSample		(bool Hit, Uint32 Microseconds, Uint32 ComputeMicroseconds);
+	bool		Find			(const DecisionKey &Key, Uint8 &Decision);
+	Uint32		GetCapacity		(void)						const;
+	Uint64		GetHits			(void)						const;
+	Uint64		GetLookups		(void)						const;
+	double		GetSpeedup		(void)						const;
+	bool		Load			(const char *Path);
+	bool		Save			(const char *Path)			const;
+	void		Store			(const DecisionKey &Key, Uint8 Decision);
+private:
+				DecisionCache	(const DecisionCache &);
+	DecisionCache &	operator=	(const DecisionCache &);
+
+	// Each stripe counts what happens under its own lock
+	struct Stripe
+	{
+		Mutex		Lock;
+		Uint64		Hits,
+					Lookups;
+	};
+
+	/* Methods */
+	Uint32		GetSlot			(Uint64 Entry)				const;
+
+	static	Uint64	GetCheck	(const DecisionKey &Key);
+
+	/* Properties */
+	std::vector<Uint64>	Entries;	// 0 when empty
+	Stripe		Stripes[DECISION_CACHE_STRIPES];
+	Mutex		SampleLock;
+	Uint64		ComputeTime,	// Spent working out the sampled misses
+				HitSamples,
+				HitTime,		// Spent on the sampled hits, key and all
+				MissSamples,
+				MissTime;		// Spent on the sampled misses, lookup and all
+};
+
+inline	Uint32	DecisionCache::GetCapacity	(void)				const
+{
+	return Entries.size();
+}
+
+}
+
+#endif
@@ -27,6 +27,20 @@ namespace _SDLMille
 	Shuffle();
 }
 
+		Deck::Deck		(Uint64 NewSeed) : Generator(NewSeed)
+{
+	Shuffle();
+}
+
+void	Deck::Arrange	(const Uint8 *Indices, Uint8 Count)
+{
+	// The undrawn part of the deck becomes these STD_DECK indices, drawn in the order given
+	Marker = DECK_SIZE - Count;
+
+	for (int i = 0; i < Count; ++i)
+		Order[Marker + i] = Indices[i];
+}
+
 int		Deck::CardsLeft	(void)	const
 {
 	return (DECK_SIZE - Marker);
@@ -48,6 +62,36 @@ bool	Deck::Empty		(void)	const
 	return !(Marker < DECK_SIZE);
 }
 
+void	Deck::Rebuild	(const Uint8 *Remaining)
+{
+	/*	Replace the undrawn part of the deck with Remaining[Value] copies of each card, in
+		random order. STD_DECK is sorted by value, so each copy maps to a distinct index. */
+	Uint8	First = 0,
+			Count = 0;
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Count += Remaining[i];
+
+	Marker = DECK_SIZE - Count;
+
+	for (int i = 0, Slot = Marker; i < CARD_NULL_NULL; ++i)
+	{
+		for (int j = 0; j < Remaining[i]; ++j, ++Slot)
+			Order[Slot] = First + j;
+
+		First += EXISTING_CARDS[i];
+	}
+
+	for (int i = DECK_SIZE - 1; i > Marker; --i)
+	{
+		int		Other = Marker + Generator.Below(i - Marker + 1);
+		Uint8	Swap = Order[i];
+
+		Order[i] = Order[Other];
+		Order[Other] = Swap;
+	}
+}
+
 bool	Deck::Restore	(FILE *SaveFile)
 {
 	if (SaveFile != 0)
@@ -78,39 +122,28 @@ bool	Deck::Save		(FILE *SaveFile)
 	return false;
 }
 
-void		Deck::Shuffle	(void)
+void	Deck::Seed		(Uint64 NewSeed)
 {
-	//TODO: Benchmark this vs. using a vector with its built-in shuffling method.
+	// Restarts the deck's random stream; the next Shuffle is the first deal of that seed
+	Generator.Seed(NewSeed);
+}
 
+void	Deck::Shuffle	(void)
+{
 	//Reset marker
 	Marker = 0;
 
-	//Clear sort order (by making each value invalid)
+	//Fisher-Yates: every ordering is equally likely, and it takes exactly DECK_SIZE - 1 draws
 	for (int i = 0; i < DECK_SIZE; ++i)
-		Order[i] = DECK_SIZE;
-
-	srand(time(NULL));
+		Order[i] = i;
 
-	//Generate dealing order
-
-	for (int i = 0; i < DECK_SIZE; ++i)
+	for (int i = DECK_SIZE - 1; i > 0; --i)
 	{
-		Uint8	RandIndex;
-		bool	Assigned =	false;
-
-		/*	The for loop gives us each value stored in STD_DECK. We then assign that
-			value to a random index in the Order array, if that index is free. */
-		do
-		{
-			RandIndex = rand() % DECK_SIZE;
-			Assigned = true;
-			if (Order[RandIndex] == DECK_SIZE)
-				Order[RandIndex] = i;
-			else if (Order[RandIndex] > DECK_SIZE)
-				exit(DECK_ERROR);
-			else
-				Assigned = false;
-		} while (Assigned == false);
+		int		Other = Generator.Below(i + 1);
+		Uint8	Swap = Order[i];
+
+		Order[i] = Order[Other];
+		Order[Other] = Swap;
 	}
 }
 
@@ -20,8 +20,9 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _SDLMILLE_DECK_H
 #define	_SDLMILLE_DECK_H
 
-#include "Surface.h"
-#include <time.h>
+#include "Random.h"
+#include <stdio.h>
+#include <stdlib.h>
 
 namespace	_SDLMille
 {
@@ -71,18 +72,29 @@ class Deck
 {
 public:
 			Deck		(void);
+	explicit	Deck	(Uint64 NewSeed);
+	void	Arrange		(const Uint8 *Indices, Uint8 Count);
 	int		CardsLeft	(void)	const;
 	Uint8	Draw		(void);
 	bool	Empty		(void)	const;
+	Uint64	GetSeed		(void)	const;
+	void	Rebuild		(const Uint8 *Remaining);
 	bool	Restore		(FILE *SaveFile);
 	bool	Save		(FILE *SaveFile);
+	void	Seed		(Uint64 NewSeed);
 	void	Shuffle		(void);
 private:
+	Random	Generator;	// Per deck, so a seed replays the same deals and threads share nothing
 	Uint8	Marker;
 	Uint8	Order[DECK_SIZE];
 	
 };
 
+inline	Uint64	Deck::GetSeed	(void)	const
+{
+	return Generator.GetSeed();
+}
+
 }
 
 #endif
@@ -0,0 +1,1647 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Engine.h"
+#include "Extension.h"
+#include "Refiner.h"
+#include "Search.h"
+#include "Solver.h"
+#include <string.h>
+
+namespace _SDLMille
+{
+/*Public methods */
+
+		Engine::Engine			(void)
+{
+	Cache = 0;
+	CacheSample = 0;
+	Observing = true;
+	Trace = 0;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+		Weights[i] = &WeightTable::GetDefault();
+
+	NewGame();
+}
+
+		Engine::Engine			(Uint64 Seed) : SourceDeck(Seed)
+{
+	Cache = 0;
+	CacheSample = 0;
+	Observing = true;
+	Trace = 0;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+		Weights[i] = &WeightTable::GetDefault();
+
+	// The deck has already shuffled from Seed, so the whole game replays from it
+	NewGame();
+}
+
+void	Engine::ChangePlayer		(void)
+{
+	if (!EndOfGame())
+	{
+		Current = 1 - Current;
+		Players[Current].Draw(&SourceDeck);
+	}
+}
+
+bool	Engine::ComputerChooseExtension	(Uint8 Level, Uint32 Milliseconds)	const
+{
+	/*	With time to spare, the stronger levels roll the rest of the hand out both ways and
+		go with the better expected margin. Otherwise, and inside rollouts, the rule of thumb
+		in ComputerDecideExtension decides. */
+	if ((Level >= DIFFICULTY_HARD) && (Milliseconds > 0))
+	{
+		ExtensionEvaluator	Odds;
+
+		if (Odds.Evaluate(*this, Current, Milliseconds))
+			return Odds.ShouldExtend();
+	}
+
+	return ComputerDecideExtension();
+}
+
+Uint8	Engine::ComputerChooseMove	(Uint8 Level, Uint32 Milliseconds)	const
+{
+	/*	Milliseconds is how long the caller can wait for the move; the stronger levels spend
+		it thinking and answer with the best move found when it runs out. Zero means no
+		deadline, and each level makes its usual fixed effort. */
+	Uint32	Start = Thread::GetMilliseconds(),
+			Elapsed;
+
+	// Once the deck runs out, the stronger levels play the rest of the hand perfectly
+	if ((Level >= DIFFICULTY_HARD) && Solver::IsSolvable(*this))
+	{
+		Solver	Endgame;
+		Uint8	Move = Endgame.ChooseMove(*this);
+
+		if (Move != MOVE_NONE)
+			return Move;
+	}
+
+	// Whatever the solver used up comes out of the budget, but a search always gets a look
+	Elapsed = Thread::GetMilliseconds() - Start;
+	if (Milliseconds > 0)
+		Milliseconds = (Elapsed < Milliseconds) ? (Milliseconds - Elapsed) : 1;
+
+	if (Level == DIFFICULTY_EXPERT)
+	{
+		Search	Expert;
+
+		if (Milliseconds > 0)
+			Expert.SetBudget(0, Milliseconds);
+
+		return Expert.ChooseMove(*this);
+	}
+
+	if (Level == DIFFICULTY_HARD)
+	{
+		Refiner	Review;
+
+		return Review.ChooseMove(*this, ComputerSmartMove(), Milliseconds);
+	}
+
+	return ComputerMove();
+}
+
+bool	Engine::ComputerDecideExtension	(void)			const
+{
+	bool	ReturnValue = true;
+	int		MileageInHand = Players[Current].MileageInHand(),	// Current is the player who completed the trip
+			MileageNeeded;
+	Uint8	CardsRemaining = SourceDeck.CardsLeft();
+
+	if (CardsRemaining < 5)
+		MileageNeeded = 300;
+	else if (CardsRemaining < 10)
+		MileageNeeded = 200;
+	else
+		MileageNeeded = 100;
+
+	if (Players[1 - Current].GetMileage() == 0)
+		ReturnValue = false;
+	else if (MileageInHand < MileageNeeded)
+		ReturnValue = false;
+
+	return ReturnValue;
+}
+
+Uint8	Engine::ComputerMove		(void)							const
+{
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (IsValidPlay(i))	// Play the first valid move we find (the computer is currently stupid)
+			return i;
+	}
+
+	for (int i = 0; i < HAND_SIZE; ++i)	//No valid moves, discard
+	{
+		if (Players[Current].GetValue(i) < CARD_NULL_NULL)
+			return i + DISCARD_OFFSET;
+	}
+
+	return MOVE_NONE;
+}
+
+Uint8	Engine::ComputerSmartMove	(void)						const
+{
+	/*	With a cache, a decision is looked up by everything it depends on. A miss is worked
+		out on a copy with the hand sorted, so ties between cards fall the same way however
+		the hand happens to be ordered, and the move doesn't depend on what is already in the
+		cache; a shared cache leaves a seeded run replayable. Traces want the reasoning, so
+		they skip the cache.
+
+		Reading the clock costs about as much as a hit saves, so only one decision in
+		DECISION_CACHE_SAMPLING is timed for the speedup. */
+	DecisionKey	Key;
+	Uint64		Start = 0, Computing = 0;
+	Uint8		Decision, Value;
+	bool		Timed;
+
+	if ((Cache == 0) || (Trace != 0))
+		return ComputerWeighMove();
+
+	Timed = (CacheSample == 0);
+	CacheSample = (CacheSample + 1) & (DECISION_CACHE_SAMPLING - 1);
+
+	if (Timed)
+		Start = Thread::GetMicroseconds();
+
+	GetDecisionKey(Key);
+
+	if (Cache->Find(Key, Decision))
+	{
+		if (Timed)
+			Cache->AddSample(true, (Uint32) (Thread::GetMicroseconds() - Start), 0);
+	}
+	else
+	{
+		Engine	Sorted = *this;
+		Uint8	Move;
+
+		Sorted.Cache = 0;
+		Sorted.Players[Current].GetHand().UnPack(Key.Bytes);	// The key starts with the sorted hand
+
+		if (Timed)
+			Computing = Thread::GetMicroseconds();
+
+		Move = Sorted.ComputerWeighMove();
+
+		if (Move < MOVE_COUNT)
+			Decision = Sorted.Players[Current].GetValue(Move % DISCARD_OFFSET) | ((Move >= DISCARD_OFFSET) ? DECISION_DISCARD : 0);
+		else
+			Decision = MOVE_NONE;
+
+		Cache->Store(Key, Decision);
+
+		if (Timed)
+		{
+			Uint64	Finish = Thread::GetMicroseconds();
+
+			Cache->AddSample(false, (Uint32) (Finish - Start), (Uint32) (Finish - Computing));
+		}
+	}
+
+	if (Decision == MOVE_NONE)
+		return MOVE_NONE;
+
+	// Any card of the chosen value will do
+	Value = Decision & ~DECISION_DISCARD;
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (Players[Current].GetValue(i) == Value)
+			return ((Decision & DECISION_DISCARD) != 0) ? i + DISCARD_OFFSET : i;
+	}
+
+	return MOVE_NONE;
+}
+
+Uint8	Engine::ComputerWeighMove	(void)						const
+{
+	// The rules of thumb themselves; ComputerSmartMove puts the cache in front of them
+	const WeightTable	&Table = *Weights[Current];
+
+	Uint8	ArrayIndex = 0,
+			MatchingCard = 0,
+			MyTopCard = Players[Current].GetTopCard(),
+			MyTopCardType = Card::GetTypeFromValue(MyTopCard),
+			Opponent = 1 - Current;
+
+	int		TripLength = (Extended) ? 1000 : 700,
+			CardsLeft = SourceDeck.CardsLeft(),
+			MileageInHand = 0,
+			MyMileage = Players[Current].GetMileage(),
+			MyRemaining = TripLength - MyMileage,
+			OpponentMileage = Players[Opponent].GetMileage(),
+			OpponentLead = OpponentMileage - MyMileage,
+			OpponentRemaining = TripLength - OpponentMileage,
+			OutstandingStopHazards = 0,
+			SafetiesInHand = 0,
+			UnknownSafeties = 0,
+			Weight[HAND_SIZE][2];
+
+	bool	MileageSaved = false,
+			MyselfLimited = Players[Current].IsLimited(),
+			MyselfOneMoveAway = false,
+			MyselfRolling = Players[Current].IsRolling(),
+			NonZeroFound = false,
+			OpponentLimited = Players[Opponent].IsLimited(),
+			OpponentOneMoveAway = false,
+			OpponentRolling = Players[Opponent].IsRolling();
+
+	/*	Populate variables	*/
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (InHand(i + SAFETY_OFFSET))
+			++SafetiesInHand;
+		else if (ExposedCards[i + SAFETY_OFFSET] < 1)
+			++UnknownSafeties;
+	}
+
+	for (int i = 0; i <= CARD_HAZARD_STOP; ++i)
+	{
+		if (i == CARD_HAZARD_SPEED_LIMIT)
+			continue;
+
+		OutstandingStopHazards += (EXISTING_CARDS[i] - KnownCards(i));
+	}
+
+	MileageInHand = Players[Current].MileageInHand();
+
+	TRACE_DECISION(Trace, TRACE_STOP_HAZARDS, Current, 0xFF, CARD_NULL_NULL, OutstandingStopHazards);
+
+	/*	Weigh cards	*/
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		Uint8	Type	= Players[Current].GetType(i),
+				Value	= Players[Current].GetValue(i);
+
+		Weight[i][0] = i;
+		Weight[i][1] = 0;
+
+		if (Value < CARD_NULL_NULL)
+		{
+			if (Type == CARD_SAFETY)
+			{
+				MatchingCard = Value - SAFETY_OFFSET;
+
+				if (Card::GetMatchingSafety(Players[Current].GetQualifiedCoupFourre()) == Value)
+				{
+					// This is a coup fourre
+					Weight[i][1] += Table.Get(WEIGHT_A00_COUP_FOURRE);
+					TRACE_DECISION(Trace, TRACE_A00, Current, i, Value, Table.Get(WEIGHT_A00_COUP_FOURRE));
+				}
+				else if (IsOneCardAway(Current) || IsOneCardAway(Opponent))
+				{
+					// Game could end. Play safeties now.
+					Weight[i][1] += Table.Get(WEIGHT_A10_GAME_ALMOST_OVER);
+					TRACE_DECISION(Trace, TRACE_A10, Current, i, Value, Table.Get(WEIGHT_A10_GAME_ALMOST_OVER));
+				}
+				else if (SafetiesInHand >= (CardsLeft - UnknownSafeties + 1))
+				{
+					Weight[i][1] += Table.Get(WEIGHT_A20_LAST_CARDS);
+					TRACE_DECISION(Trace, TRACE_A20, Current, i, Value, Table.Get(WEIGHT_A20_LAST_CARDS));
+				}
+				else if (Value == CARD_SAFETY_RIGHT_OF_WAY)
+				{
+					if ((KnownCards(CARD_HAZARD_SPEED_LIMIT) == EXISTING_CARDS[CARD_HAZARD_SPEED_LIMIT]) && (KnownCards(CARD_HAZARD_STOP) == EXISTING_CARDS[CARD_HAZARD_STOP]))
+					{
+						// No hazards left. No value in keeping it.
+						Weight[i][1] += Table.Get(WEIGHT_A30_ROW_NO_HAZARDS);
+						TRACE_DECISION(Trace, TRACE_A30, Current, i, Value, Table.Get(WEIGHT_A30_ROW_NO_HAZARDS));
+					}
+					else if ((OpponentLead > 200) || (OpponentRemaining <= 200))
+					{
+						if (!MyselfRolling && ((MyTopCardType == CARD_REMEDY) || (MyTopCard == CARD_HAZARD_STOP) || (MyTopCard == CARD_NULL_NULL)) && (InHand(CARD_REMEDY_ROLL) < 1))
+						{
+							// Get us rolling
+							Weight[i][1] += Table.Get(WEIGHT_A40_ROW_TO_ROLL);
+							TRACE_DECISION(Trace, TRACE_A40, Current, i, Value, Table.Get(WEIGHT_A40_ROW_TO_ROLL));
+						}
+						else if (MyselfRolling && MyselfLimited && (InHand(CARD_REMEDY_END_LIMIT) < 1))
+						{
+							// Unlimit ourselves
+							Weight[i][1] += Table.Get(WEIGHT_A50_ROW_TO_UNLIMIT);
+							TRACE_DECISION(Trace, TRACE_A50, Current, i, Value, Table.Get(WEIGHT_A50_ROW_TO_UNLIMIT));
+						}
+					}
+					else if (!MyselfRolling && ((MyTopCardType == CARD_REMEDY) || (MyTopCard == CARD_HAZARD_STOP) || (MyTopCard == CARD_NULL_NULL)) && (UnknownCards(CARD_REMEDY_ROLL) <= 0) && (InHand(CARD_REMEDY_ROLL) < 1))
+					{
+						// No more roll cards. Play the RoW
+						Weight[i][1] += Table.Get(WEIGHT_A52_ROW_NO_ROLLS);
+						TRACE_DECISION(Trace, TRACE_A52, Current, i, Value, Table.Get(WEIGHT_A52_ROW_NO_ROLLS));
+					}
+					else if (MyselfLimited && (UnknownCards(CARD_REMEDY_END_LIMIT) <= 0) && (InHand(CARD_REMEDY_END_LIMIT) < 1))
+					{
+						// No more speed remedies. Play the RoW
+						Weight[i][1] += Table.Get(WEIGHT_A54_ROW_NO_END_LIMITS);
+						TRACE_DECISION(Trace, TRACE_A54, Current, i, Value, Table.Get(WEIGHT_A54_ROW_NO_END_LIMITS));
+					}
+					else
+					{
+						TRACE_DECISION(Trace, TRACE_A56, Current, i, Value, 0);
+					}
+				}
+				else if (KnownCards(MatchingCard) == EXISTING_CARDS[MatchingCard])
+				{
+					// No more hazards to go with it. No use in saving it
+					Weight[i][1] += Table.Get(WEIGHT_A60_NO_HAZARDS);
+					TRACE_DECISION(Trace, TRACE_A60, Current, i, Value, Table.Get(WEIGHT_A60_NO_HAZARDS));
+				}
+				else if ((Players[Current].GetTopCard(false) == (Value - 10)) && ((InHand(Value - 5) < 1) && ((OpponentLead > 200) || (OpponentRemaining <= 200) || (UnknownCards(Value - 5) <= 0))))
+				{
+					// Get us out of the jam
+					Weight[i][1] += Table.Get(WEIGHT_A70_OUT_OF_JAM);
+					TRACE_DECISION(Trace, TRACE_A70, Current, i, Value, Table.Get(WEIGHT_A70_OUT_OF_JAM));
+				}
+				else
+				{
+					// Leave weight at 0 to save card
+					TRACE_DECISION(Trace, TRACE_A80, Current, i, Value, 0);
+				}
+
+				//	11 paths for safeties
+			}
+			else if (Type == CARD_REMEDY)
+			{
+				Uint8	TopCard = CARD_NULL_NULL;
+
+				// Get corresponding hazard
+				MatchingCard = Value - 5;
+				TopCard = Players[Current].GetTopCard((MatchingCard == CARD_HAZARD_SPEED_LIMIT));
+
+				if (Players[Current].HasSafety(Card::GetMatchingSafety(MatchingCard)))
+				{
+					// We have the safety, our remedy is useless
+					Weight[i][1] += Table.Get(WEIGHT_B00_HAVE_SAFETY);
+					TRACE_DECISION(Trace, TRACE_B00, Current, i, Value, Table.Get(WEIGHT_B00_HAVE_SAFETY));
+				}
+				else if (Value == CARD_REMEDY_ROLL)
+				{
+					if (!MyselfRolling && ((Card::GetTypeFromValue(TopCard) == CARD_REMEDY) || (TopCard == CARD_HAZARD_STOP) || (TopCard == CARD_NULL_NULL)))
+					{
+						// Get us rolling
+						Weight[i][1] += Table.Get(WEIGHT_B03_ROLL);
+						TRACE_DECISION(Trace, TRACE_B03, Current, i, Value, Table.Get(WEIGHT_B03_ROLL));
+					}
+					else if (InHand(CARD_REMEDY_ROLL) > std::min(3, OutstandingStopHazards))
+					{
+						// Too many roll cards on hand. Lose some.
+						Weight[i][1] += Table.Get(WEIGHT_B06_TOO_MANY_ROLLS);
+						TRACE_DECISION(Trace, TRACE_B06, Current, i, Value, Table.Get(WEIGHT_B06_TOO_MANY_ROLLS));
+					}
+					else if (InHand(CARD_SAFETY_RIGHT_OF_WAY))
+					{
+						// We hold the RoW. The roll is less valuable, but we still want to keep it if we can
+						Weight[i][1] += Table.Get(WEIGHT_B09_ROLL_WITH_ROW);
+						TRACE_DECISION(Trace, TRACE_B09, Current, i, Value, Table.Get(WEIGHT_B09_ROLL_WITH_ROW));
+					}
+					else
+					{
+						// General roll remedy
+						Weight[i][1] += Table.Get(WEIGHT_B12_ROLL);
+						TRACE_DECISION(Trace, TRACE_B12, Current, i, Value, Table.Get(WEIGHT_B12_ROLL));
+					}
+				}
+				else if (TopCard == MatchingCard)
+				{
+					// A remedy for our current situation
+					Weight[i][1] += Table.Get(WEIGHT_B20_CURRENT_HAZARD);
+					TRACE_DECISION(Trace, TRACE_B20, Current, i, Value, Table.Get(WEIGHT_B20_CURRENT_HAZARD));
+				}
+				else if ((KnownCards(MatchingCard) == EXISTING_CARDS[MatchingCard]) || (InHand(Value) > (EXISTING_CARDS[MatchingCard] - KnownCards(MatchingCard))) || (InHand(Value + 5) > 0))
+				{
+					/*	Matching hazard has been exhausted. No use in keeping the remedy
+						OR we have more than we need
+						OR we hold the safety			*/
+					Weight[i][1] += Table.Get(WEIGHT_B30_NOT_NEEDED);
+					TRACE_DECISION(Trace, TRACE_B30, Current, i, Value, Table.Get(WEIGHT_B30_NOT_NEEDED));
+				}
+				else
+				{
+					int	KnownCount = KnownCards(MatchingCard);
+
+					// Doesn't help us right now, but we might need it later
+					Weight[i][1] += Table.Get(WEIGHT_B40_GENERAL);
+					TRACE_DECISION(Trace, TRACE_B40, Current, i, Value, Table.Get(WEIGHT_B40_GENERAL));
+
+					if (InHand(Value) > 1)
+					{
+						// We hold more than 1
+						Weight[i][1] += Table.Get(WEIGHT_B42_DUPLICATE);
+						TRACE_DECISION(Trace, TRACE_B42, Current, i, Value, Table.Get(WEIGHT_B42_DUPLICATE));
+					}
+					else if (UnknownCards(Value) < 2)
+					{
+						// Slim chance of getting another one. Better hold on to it.
+						Weight[i][1] += Table.Get(WEIGHT_B44_ALMOST_GONE);
+						TRACE_DECISION(Trace, TRACE_B44, Current, i, Value, Table.Get(WEIGHT_B44_ALMOST_GONE));
+					}
+					else if (KnownCount > 0)
+					{
+						// Remedy becomes less valuable with fewer outstanding hazards
+						Weight[i][1] += KnownCount * Table.Get(WEIGHT_B46_PER_KNOWN_HAZARD);
+						TRACE_DECISION(Trace, TRACE_B46, Current, i, Value, KnownCount * Table.Get(WEIGHT_B46_PER_KNOWN_HAZARD));
+					}
+				}
+
+				//	11 paths for remedies
+			}
+			else if (Type == CARD_HAZARD)
+			{
+				MatchingCard = Value + 5;
+
+				if (Players[Opponent].HasSafety(Card::GetMatchingSafety(Value)))
+				{
+					// Hazard is useless
+					Weight[i][1] += Table.Get(WEIGHT_C00_OPPONENT_SAFE);
+					TRACE_DECISION(Trace, TRACE_C00, Current, i, Value, Table.Get(WEIGHT_C00_OPPONENT_SAFE));
+				}
+				else if ((Value == CARD_HAZARD_SPEED_LIMIT) && !OpponentRolling && (OpponentMileage == 0) && (MayHaveRoW(Opponent)))
+				{
+					if (InHand(CARD_HAZARD_SPEED_LIMIT) == 1)
+					{
+						// Leave value at 0 so we'll save it, but not play it
+						TRACE_DECISION(Trace, TRACE_C03, Current, i, Value, 0);
+					}
+					else
+					{
+						// We don't want to give away our chance at a shutout
+						Weight[i][1] += Table.Get(WEIGHT_C06_SHUTOUT_RISK);
+						TRACE_DECISION(Trace, TRACE_C06, Current, i, Value, Table.Get(WEIGHT_C06_SHUTOUT_RISK));
+					}
+				}
+				else
+				{
+					int KnownCount = KnownCards(MatchingCard);
+
+					if (IsOneCardAway(Opponent) || (!IsOneCardAway(Current) && ((OpponentMileage == 0) || (OpponentRemaining <= 200) || (OpponentLead >= 200))))
+					{
+						// We need to stop the opponent if possible
+						Weight[i][1] += Table.Get(WEIGHT_C10_MUST_STOP);
+						TRACE_DECISION(Trace, TRACE_C10, Current, i, Value, Table.Get(WEIGHT_C10_MUST_STOP));
+					}
+					else
+					{
+						// No pressing need right now
+						Weight[i][1] += Table.Get(WEIGHT_C20_GENERAL);
+						TRACE_DECISION(Trace, TRACE_C20, Current, i, Value, Table.Get(WEIGHT_C20_GENERAL));
+					}
+
+					if (KnownCount > 0)
+					{
+						// Hazard becomes more valuable with fewer outstanding remedies.
+						Weight[i][1] += KnownCount * Table.Get(WEIGHT_C20_PER_KNOWN_REMEDY);
+						TRACE_DECISION(Trace, TRACE_C20_KNOWN, Current, i, Value, KnownCount * Table.Get(WEIGHT_C20_PER_KNOWN_REMEDY));
+					}
+
+					if (!CouldHoldCard(Opponent, MatchingCard))
+					{
+						// Opponent could not hold the remedy
+						Weight[i][1] += Table.Get(WEIGHT_C30_NO_REMEDY);
+						TRACE_DECISION(Trace, TRACE_C30, Current, i, Value, Table.Get(WEIGHT_C30_NO_REMEDY));
+					}
+
+					if (!CouldHoldCard(Opponent, Card::GetMatchingSafety(Value)))
+					{
+						// Opponent could not hold the safety
+						Weight[i][1] += Table.Get(WEIGHT_C40_NO_SAFETY);
+						TRACE_DECISION(Trace, TRACE_C40, Current, i, Value, Table.Get(WEIGHT_C40_NO_SAFETY));
+					}
+
+					if ((Value == CARD_HAZARD_SPEED_LIMIT) && OpponentRolling)
+					{
+						// Prefer to play a stop hazard over just a speed limit
+						Weight[i][1] += Table.Get(WEIGHT_C50_LIMIT_ROLLING);
+						TRACE_DECISION(Trace, TRACE_C50, Current, i, Value, Table.Get(WEIGHT_C50_LIMIT_ROLLING));
+					}
+				}
+
+				//	8 paths for hazards
+			}
+			else if (Type == CARD_MILEAGE)
+			{
+				Uint8	MileValue		= Card::GetMileValue(Value),
+						My200Count		= Players[Current].GetPileCount(CARD_MILEAGE_200),
+						My200Remaining	= 2 - My200Count;
+
+				if (MileValue > MyRemaining)
+				{
+					// Would take us past end of trip
+					if (Extended)
+						// Card is totally useless
+						Weight[i][1] += Table.Get(WEIGHT_D00_PAST_END_EXTENDED);
+					else
+						// Card is mostly useless
+						Weight[i][1] += Table.Get(WEIGHT_D00_PAST_END);
+
+					TRACE_DECISION(Trace, TRACE_D00, Current, i, Value, Weight[i][1]);
+				}
+				else if (Value == CARD_MILEAGE_200)
+				{
+					if (My200Remaining < 1)
+					{
+						//Useless. Cannot be played.
+						Weight[i][1] += Table.Get(WEIGHT_D03_NO_200S_LEFT);
+						TRACE_DECISION(Trace, TRACE_D03, Current, i, Value, Table.Get(WEIGHT_D03_NO_200S_LEFT));
+					}
+					else if (!MyselfRolling && (InHand(CARD_MILEAGE_200) > My200Remaining))
+					{
+						// More 200's than we can use
+						Weight[i][1] += Table.Get(WEIGHT_D06_SPARE_200S);
+						TRACE_DECISION(Trace, TRACE_D06, Current, i, Value, Table.Get(WEIGHT_D06_SPARE_200S));
+					}
+					else
+					{
+						if (MyRemaining == 200)
+						{
+							if ((My200Count == 0) && ((InHand(CARD_MILEAGE_100) > 0) || (MileageInHand >= 100)) && !IsOneCardAway(Opponent) && (CardsLeft > 10))
+							{
+								// No pressing need to break 200
+								Weight[i][1] += Table.Get(WEIGHT_D09_DEFER_200);
+								TRACE_DECISION(Trace, TRACE_D09, Current, i, Value, Table.Get(WEIGHT_D09_DEFER_200));
+							}
+							else
+							{
+								// Finish the hand
+								Weight[i][1] += Table.Get(WEIGHT_D12_FINISH_WITH_200);
+								TRACE_DECISION(Trace, TRACE_D12, Current, i, Value, Table.Get(WEIGHT_D12_FINISH_WITH_200));
+							}
+						}
+						else if (MyRemaining == 225)
+						{
+							// Prefer a 25 over this
+							Weight[i][1] += Table.Get(WEIGHT_D15_200_LEAVES_25);
+							TRACE_DECISION(Trace, TRACE_D15, Current, i, Value, Table.Get(WEIGHT_D15_200_LEAVES_25));
+						}
+						else if ((OpponentLead > 200) || (My200Count > 0))
+						{
+							// We need to catch up, or we've already played a 200
+							Weight[i][1] += Table.Get(WEIGHT_D18_200_CATCH_UP);
+							TRACE_DECISION(Trace, TRACE_D18, Current, i, Value, Table.Get(WEIGHT_D18_200_CATCH_UP));
+						}
+						else
+						{
+							// No need to play it yet. Equal with 25.
+							Weight[i][1] += Table.Get(WEIGHT_D21_200);
+							TRACE_DECISION(Trace, TRACE_D21, Current, i, Value, Table.Get(WEIGHT_D21_200));
+						}
+					}
+				}
+				else if (MileValue == MyRemaining)
+				{
+					// Card could win us the hand
+					Weight[i][1] += Table.Get(WEIGHT_D30_FINISH);
+					TRACE_DECISION(Trace, TRACE_D30, Current, i, Value, Table.Get(WEIGHT_D30_FINISH));
+				}
+				else if (MyRemaining <= 200)
+				{
+					// We have to be careful in the last part of the trip
+					int	MileBalance = MyRemaining - MileValue;
+
+					if (MileBalance <= 100)
+					{
+						if ((MileBalance == MileValue) && (InHand(Value) > 1))
+						{
+							// Hand could be one in two plays, including this play
+							Weight[i][1] += Table.Get(WEIGHT_D35_PAIR_FINISHES);
+							TRACE_DECISION(Trace, TRACE_D35, Current, i, Value, Table.Get(WEIGHT_D35_PAIR_FINISHES));
+						}
+						else if ((MileBalance != MileValue) && (InHand(Card::GetCardFromMileage(MileBalance)) > 0))
+						{
+							// Hand could be one in two plays, including this play
+							Weight[i][1] += Table.Get(WEIGHT_D36_PAIR_FINISHES);
+							TRACE_DECISION(Trace, TRACE_D36, Current, i, Value, Table.Get(WEIGHT_D36_PAIR_FINISHES));
+						}
+						else if (MileBalance > 25)
+						{
+							// Gets us close, but not too close
+							if (MileBalance == 100)
+							{
+								Weight[i][1] += Table.Get(WEIGHT_D40_LEAVES_100);
+								TRACE_DECISION(Trace, TRACE_D40, Current, i, Value, Table.Get(WEIGHT_D40_LEAVES_100));
+							}
+							else if (MileBalance > 50)
+							{
+								Weight[i][1] += Table.Get(WEIGHT_D43_LEAVES_75);
+								TRACE_DECISION(Trace, TRACE_D43, Current, i, Value, Table.Get(WEIGHT_D43_LEAVES_75));
+							}
+							else
+							{
+								Weight[i][1] += Table.Get(WEIGHT_D46_LEAVES_50);
+								TRACE_DECISION(Trace, TRACE_D46, Current, i, Value, Table.Get(WEIGHT_D46_LEAVES_50));
+							}
+						}
+						else
+						{
+							// Would leave us with only 25 miles left.
+							if (InHand(Value) > 1)
+							{
+								Weight[i][1] += Table.Get(WEIGHT_D48_LEAVES_25);
+								TRACE_DECISION(Trace, TRACE_D48, Current, i, Value, Table.Get(WEIGHT_D48_LEAVES_25));
+							}
+							else
+							{
+								TRACE_DECISION(Trace, TRACE_D49, Current, i, Value, 0);
+							}
+						}
+					}
+					else
+					{
+						// Give some weight to it, but not much. Would require at least two more plays after this one
+						Weight[i][1] += Table.Get(WEIGHT_D60_NEARING_END);
+						TRACE_DECISION(Trace, TRACE_D60, Current, i, Value, Table.Get(WEIGHT_D60_NEARING_END));
+					}
+				}
+				else if ((MyMileage == 0) && (MileValue == 25) && !InHand(CARD_MILEAGE_50) && !MyselfRolling && !MileageSaved && !Players[Current].HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && !InHand(CARD_SAFETY_RIGHT_OF_WAY) && (KnownCards(CARD_HAZARD_SPEED_LIMIT) < EXISTING_CARDS[CARD_HAZARD_SPEED_LIMIT]))
+				{
+					// Save one low mileage in case we get limited, to prevent shutout
+					TRACE_DECISION(Trace, TRACE_D70, Current, i, Value, 0);
+					MileageSaved = true;
+				}
+				else if ((MyMileage == 0) && (MileValue == 50) && !MyselfRolling && !MileageSaved && !Players[Current].HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && !InHand(CARD_SAFETY_RIGHT_OF_WAY) && (KnownCards(CARD_HAZARD_SPEED_LIMIT) < EXISTING_CARDS[CARD_HAZARD_SPEED_LIMIT]))
+				{
+					// Save one low mileage in case we get limited, to prevent shutout
+					TRACE_DECISION(Trace, TRACE_D75, Current, i, Value, 0);
+					MileageSaved = true;
+				}
+				else
+				{
+					// Weight based on mileage
+					Weight[i][1] += (MileValue / 25) * Table.Get(WEIGHT_D80_PER_25_MILES);
+					TRACE_DECISION(Trace, TRACE_D80, Current, i, Value, (MileValue / 25) * Table.Get(WEIGHT_D80_PER_25_MILES));
+				}
+
+				//if (MyselfRolling && IsOneCardAway(Opponent) && (MileValue <= MyRemaining))
+				//{
+				//	// Game is almost over. Play some mileage to help even the score
+				//	printf("D90: Opponent could close it up. Play some mileage now\n");
+				//	Weight[i][1] = std::min(90, 50 + Value - MILEAGE_OFFSET);
+				//}
+
+				//	22 paths for mileage
+			}
+
+			TRACE_DECISION(Trace, TRACE_WEIGHT, Current, i, Value, Weight[i][1]);
+
+			if (Weight[i][1] != 0)
+				NonZeroFound = true;
+		}
+	}
+
+	/*	Sort by weight, descending	*/
+
+	for (int i = 0; i < (HAND_SIZE - 1); ++i)
+	{
+		bool Sorted = false;
+
+		while (!Sorted)
+		{
+			Sorted = true;
+
+			for (int j = i; j < (HAND_SIZE - 1); ++j)
+			{
+				if (Weight[j][1] < Weight[j+1][1])
+				{
+					int	TempIndex = Weight[j][0],
+						TempWeight = Weight[j][1];
+
+					Weight[j][0] = Weight[j+1][0];
+					Weight[j][1] = Weight[j+1][1];
+
+					Weight[j+1][0] = TempIndex;
+					Weight[j+1][1] = TempWeight;
+
+					Sorted = false;
+				}
+			}
+		}
+	}
+
+	/*	Play a card, if possible	*/
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		Uint8 Index = Weight[i][0];
+
+		if ((Weight[i][1] >= 0) && IsValidPlay(Index) && ((Weight[i][1] != 0) || (!NonZeroFound)))
+		{
+			TRACE_DECISION(Trace, TRACE_PLAY, Current, Index, Players[Current].GetValue(Index), Weight[i][1]);
+			return Index;
+		}
+	}
+	
+	/*	Discard if necessary	*/
+
+	for (int i = HAND_SIZE - 1; i >= 0; --i)
+	{
+		Uint8 Index = Weight[i][0];
+
+		if ((Players[Current].GetValue(Index) < CARD_NULL_NULL) && (Players[Current].GetType(Index) != CARD_SAFETY) && ((Weight[i][1] != 0) || (!NonZeroFound)))
+		{
+			TRACE_DECISION(Trace, TRACE_DISCARD, Current, Index, Players[Current].GetValue(Index), Weight[i][1]);
+			return Index + DISCARD_OFFSET;
+		}
+	}
+
+	return MOVE_NONE;
+}
+
+bool	Engine::CouldHoldCard		(Uint8 PlayerIndex, Uint8 Value)			const
+{
+	Uint8	NumberExisting	= 0,
+			NumberExposed	= 0,
+			NumberInHand	= 0;
+	bool	IsCurrentPlayer	= (PlayerIndex == Current),
+			ReturnValue		= false;
+
+	if (Value < CARD_NULL_NULL)
+	{
+		NumberExisting = EXISTING_CARDS[Value];
+		NumberExposed = ExposedCards[Value];
+		NumberInHand = InHand(Value);
+
+		if (NumberExposed < NumberExisting)
+		{
+			// Someone could hold the card
+
+			if (NumberInHand > 0)
+			{
+				if (IsCurrentPlayer)
+					// We have the card
+					ReturnValue = true;
+				else if (NumberExposed + NumberInHand == NumberExisting)
+					// We have the rest of the cards; opponent cannot hold one
+					ReturnValue = false;
+				else
+					ReturnValue = true;
+			}
+			else if (IsCurrentPlayer)
+				// Card is not in our hand
+				ReturnValue = false;
+			else
+				// We don't have the card, opponent may
+				ReturnValue = true;
+		}			
+	}
+
+	/*	The opponent may hold a copy, but the way they have played can make it unlikely.
+		The threshold is in percent; at zero, any chance at all counts. */
+	if (ReturnValue && !IsCurrentPlayer)
+		ReturnValue = (GetHoldProbability(PlayerIndex, Value) * 100) >= Weights[Current]->Get(WEIGHT_E00_BELIEF_THRESHOLD);
+
+	return ReturnValue;
+}
+
+bool	Engine::Discard			(Uint8 Index)
+{
+	Uint8	Value	= Players[Current].GetValue(Index);
+
+	if ((Index < HAND_SIZE) && (Value < CARD_NULL_NULL) && (Card::GetTypeFromValue(Value) != CARD_SAFETY))
+	{
+		if (Observing)
+			Observe(Value, true);
+		Players[Current].Detach(Index);
+		Animate(Index, ANIMATION_DISCARD);
+		DiscardTop = Value;	// Put the card on top of the discard pile
+		Players[Current].Discard(Index);
+
+		++ExposedCards[Value];
+
+		Players[Current].UnPop(Index);
+		ChangePlayer();
+
+		return true;
+	}
+
+	return false;
+}
+
+bool	Engine::EndOfGame			(void)								const
+{
+	bool	ReturnValue	= true;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		ReturnValue &= Players[i].IsOutOfCards();	// Players are all out of cards
+	}
+
+	if (!ReturnValue)
+	{
+		for (int i = 0; i < PLAYER_COUNT; ++i)
+		{
+			ReturnValue |= (Players[i].GetMileage() == ((Extended) ? 1000 : 700));	// A player has completed the trip
+		}
+	}
+
+	return ReturnValue;
+}
+
+void	Engine::Extend			(bool Extending)
+{
+	if (Extending)
+	{
+		Extended = true;
+		ChangePlayer();
+	}
+	else
+		ExtensionDeclined = true;
+}
+
+Uint64	Engine::GetHash			(void)								const
+{
+	/*	Zobrist hash of the position as the rules see it: both hands (as multisets), tableaux,
+		Coup Fourre qualifications, cards left, extension and the side to move. The players
+		keep their parts current, so this is O(1). The second player's part is rotated so the
+		same cards on the other side of the table hash differently. */
+	Uint64	Second = Players[1].GetHash(),
+			Result = Players[0].GetHash() ^ ((Second << 32) | (Second >> 32))
+				^ GetZobristKey(ZOBRIST_CARDS_LEFT + SourceDeck.CardsLeft());
+
+	if (Current != 0)
+		Result ^= GetZobristKey(ZOBRIST_CURRENT);
+	if (Extended)
+		Result ^= GetZobristKey(ZOBRIST_EXTENDED);
+	if (ExtensionDeclined)
+		Result ^= GetZobristKey(ZOBRIST_EXTENSION_DECLINED);
+
+	return Result;
+}
+
+double	Engine::GetHoldProbability	(Uint8 PlayerIndex, Uint8 Value)	const
+{
+	// As far as the current player can tell
+	Uint8	Unseen[CARD_NULL_NULL];
+
+	if (Value >= CARD_NULL_NULL)
+		return 0;
+
+	if (PlayerIndex == Current)
+		return (InHand(Value) > 0) ? 1 : 0;
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Unseen[i] = UnknownCards(i);
+
+	return Beliefs[PlayerIndex].GetProbability(Value, Unseen, Players[PlayerIndex].CardsInHand());
+}
+
+Uint8	Engine::GetOutcome		(void)								const
+{
+	/* Determine outcome of the game from the first player's point of view */
+	Uint8	Outcome = OUTCOME_NOT_OVER;
+
+	if (ScoreBreakdown[0][SCORE_CATEGORY_COUNT - 1] >= 5000)
+	{
+		Outcome = OUTCOME_WON;
+
+		for (int i = 1; i < PLAYER_COUNT; ++i)
+		{
+			if (ScoreBreakdown[i][SCORE_CATEGORY_COUNT - 1] >= ScoreBreakdown[0][SCORE_CATEGORY_COUNT - 1])
+			{
+				if (ScoreBreakdown[i][SCORE_CATEGORY_COUNT - 1] > ScoreBreakdown[0][SCORE_CATEGORY_COUNT - 1])
+				{
+					Outcome = OUTCOME_LOST;
+					break;
+				}
+				else
+					Outcome = OUTCOME_DRAW;
+			}
+		}
+	}
+	else
+	{
+		for (int i = 1; i < PLAYER_COUNT; ++i)
+		{
+			if (ScoreBreakdown[i][SCORE_CATEGORY_COUNT - 1] >= 5000)
+			{
+				Outcome = OUTCOME_LOST;
+				break;
+			}
+		}
+	}
+
+	return Outcome;
+}
+
+void	Engine::GetScores			(void)
+{
+	if (EndOfGame())
+	{
+		for (int i = 0; i < PLAYER_COUNT; ++i)
+		{
+			int Score = 0,
+				PlayerSafetyCount = 0, PlayerCoupFourreCount = 0,
+				CategoryIndex = 0;
+
+			/* Points scored by everyone */
+
+			// Distance (1pt per mile travelled)
+			Score += Players[i].GetMileage();
+			ScoreBreakdown[i][CategoryIndex] = Score;
+			++CategoryIndex;
+			
+			for (int j = 0; j < SAFETY_COUNT; ++j) // Get info about safeties and Coup Fourres
+			{
+				if (Players[i].HasSafety(j + SAFETY_OFFSET))
+				{
+					++PlayerSafetyCount;
+					if (Players[i].HasCoupFourre(j + SAFETY_OFFSET))
+						++PlayerCoupFourreCount;
+				}
+			}
+
+			// 100pt for each safety, no matter how played
+			if (PlayerSafetyCount)
+			{
+				int SafetyScore = PlayerSafetyCount * 100;
+				Score += SafetyScore;
+				ScoreBreakdown[i][CategoryIndex] = SafetyScore;
+			}
+			++CategoryIndex;
+
+			// 300pt bonus for all four safeties
+			if (PlayerSafetyCount == 4)
+			{
+				Score += 300;
+				ScoreBreakdown[i][CategoryIndex] = 300;
+			}
+			++CategoryIndex;
+
+			// 300pt bonus for each Coup Fourre
+			if (PlayerCoupFourreCount)
+			{
+				int CoupFourreScore = PlayerCoupFourreCount * 300;
+				Score += CoupFourreScore;
+				ScoreBreakdown[i][CategoryIndex] += CoupFourreScore;
+			}
+			++CategoryIndex;
+
+			/* Points scored only by the player which completed the trip */
+
+			if (Players[i].GetMileage() == ((Extended) ? 1000 : 700))
+			{
+				// 400pt for completing trip
+				Score += 400;
+				ScoreBreakdown[i][CategoryIndex] = 400;
+				++CategoryIndex;
+
+				// 300pt bonus for delayed action (draw pile exhausted before trip completion)
+				if (SourceDeck.Empty())
+				{
+					Score += 300;
+					ScoreBreakdown[i][CategoryIndex] = 300;
+				}
+				++CategoryIndex;
+
+				// 300pt bonus for safe trip (no 200-mile cards)
+				if (Players[i].GetPileCount(CARD_MILEAGE_200) == 0)
+				{
+					Score += 300;
+					ScoreBreakdown[i][CategoryIndex] = 300;
+				}
+				++CategoryIndex;
+
+				// 200pt bonus for completing an extended trip
+				if (Extended)
+				{
+					Score += 200;
+					ScoreBreakdown[i][CategoryIndex] = 200;
+				}
+				++CategoryIndex;
+
+				// 500pt shutout bonus (opponent did not play any mileage cards during the hand)
+				if (Players[1 - i].GetMileage() == 0)
+				{
+					Score += 500;
+					ScoreBreakdown[i][CategoryIndex] = 500;
+				}
+			}
+			else
+				CategoryIndex += 4;
+
+			++CategoryIndex;
+
+			Scores[i] = Score;
+			ScoreBreakdown[i][CategoryIndex] = Score;	//Set subtotal
+
+			++CategoryIndex;
+
+			ScoreBreakdown[i][CategoryIndex] = RunningScores[i];	//Set previous score
+
+			++CategoryIndex;
+
+			ScoreBreakdown[i][CategoryIndex] = RunningScores[i] + Score;	//Set total score
+		}
+	}
+}
+
+Uint8	Engine::InHand			(Uint8 Value)						const
+{
+	return Players[Current].GetCount(Value);
+}
+
+bool	Engine::IsExtensionPending	(void)							const
+{
+	// The trip was just completed, and nobody has decided whether to extend it yet
+	if (EndOfGame() && !Extended && !ExtensionDeclined)
+		return (Players[Current].GetMileage() == 700);
+
+	return false;
+}
+
+bool	Engine::IsHandOver		(void)								const
+{
+	// An uncompleted trip can't be extended, so the hand is over as soon as the cards run out
+	return (EndOfGame() && !IsExtensionPending());
+}
+
+bool	Engine::IsOneCardAway		(Uint8 PlayerIndex)					const
+{
+	int		Mileage = Players[PlayerIndex].GetMileage(),
+			RemainingMileage = ((Extended) ? 1000 : 700) - Mileage;
+
+	Uint8	CardCount = Players[PlayerIndex].CardsInHand(),
+			TopCard = Players[PlayerIndex].GetTopCard(),
+			MatchingSafety = Card::GetMatchingSafety(TopCard),
+			ValueNeeded = CARD_NULL_NULL;
+
+	bool	CouldHaveRoW = MayHaveRoW(PlayerIndex),
+			CouldRoll = false,
+			IsCurrentPlayer = (PlayerIndex == Current),
+			IsLimited = Players[PlayerIndex].IsLimited(),
+			IsRolling = Players[PlayerIndex].IsRolling();
+
+	if (CardCount < 1)
+		// Can't with without any cards
+		return false;
+	
+	if (!IsRolling)
+	{
+		if (CardCount < 2)
+			// Not enough cards to start rolling and play a mileage
+			return false;
+		else if (!CouldHaveRoW)
+			// Can't have ROW card, no way to roll and play mileage in one turn
+			return false;
+	}
+
+	if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (!CouldHoldCard(PlayerIndex, MatchingSafety)))
+		//Player is afflicted by a hazard and can't hold the safety
+		return false;
+
+	if (IsLimited && !CouldHaveRoW && (RemainingMileage > 50))
+		// Player is limited, could not hold ROW, and has more than 50 miles to go
+		return false;
+
+	ValueNeeded = Card::GetCardFromMileage(RemainingMileage);
+
+	if (ValueNeeded == 0xFF)
+		// No single mileage card covers the distance
+		return false;
+
+	if (!CouldHoldCard(PlayerIndex, ValueNeeded))
+		// Could not hold required mileage card
+		return false;
+
+	if ((ValueNeeded == CARD_MILEAGE_200) && (Players[PlayerIndex].GetPileCount(CARD_MILEAGE_200) > 1))
+		// Needs a 200 and has already exhausted limit
+		return false;
+
+	return true;
+}
+
+bool	Engine::IsValidCard		(Uint8 Value)						const
+{
+	// Whether the current player could play a card of this value, if they held one
+	Uint8	Type =	Card::GetTypeFromValue(Value);
+
+	if (Type == CARD_NULL)
+		// The player tapped an empty slot
+		return false;
+
+	if (Type == CARD_MILEAGE)
+	{
+		Uint8 MileageValue = Card::GetMileValue(Value);
+
+		if (!Players[Current].IsRolling())
+			// Must be rolling to play mileage cards
+			return false;
+
+		if (Players[Current].IsLimited())
+		{
+			// Enforce speed limit
+			if (MileageValue > 50)
+				return false;
+		}
+
+		if ((Value == CARD_MILEAGE_200) && (Players[Current].GetPileCount(CARD_MILEAGE_200) > 1))
+			// Cannot play more than two 200-mile cards
+			return false;
+
+		//Cannot go past trip end, 1000 miles if the trip was extended, otherwise 700
+		if ((MileageValue + Players[Current].GetMileage()) > ((Extended) ? 1000 : 700))
+			// Cannot go past end of trip
+			return false;
+		
+		return true;
+	}
+	
+	if (Type == CARD_HAZARD)
+	{
+		if (Players[1 - Current].HasSafety(Card::GetMatchingSafety(Value)))
+			// If our opponent has the matching safety, the hazard can't be played
+			return false;
+
+		if (Value == CARD_HAZARD_SPEED_LIMIT)
+		{
+			if (Players[1 - Current].IsLimited())
+				// Opponent is already limited
+				return false;
+		}
+		else
+		{
+			if (!Players[1 - Current].IsRolling())
+				// Cannot play other hazards unless opponent is rolling
+				return false;
+		}
+
+		return true;
+	}
+	
+	if (Type == CARD_REMEDY)
+	{
+		Uint8 TopCard =		Players[Current].GetTopCard();
+		Uint8 TopCardType = Card::GetTypeFromValue(TopCard);
+		
+		if (Value == CARD_REMEDY_ROLL)
+		{
+			if ((TopCardType != CARD_REMEDY) && (TopCard != CARD_HAZARD_STOP) && (TopCard != CARD_NULL_NULL) && !Players[Current].HasSafety(Card::GetMatchingSafety(TopCard)))
+				/* Are we:	1. Playing on top of a remedy
+							2. Playing on top of a "stop" card
+							3. Playing on an empty battle pile
+							4. Playing on a hazard to which we have the matching safety */
+				return false;
+
+			if (Players[Current].IsRolling())
+				// We're already rolling
+				return false;
+		}
+		else
+		{
+			if (Value == CARD_REMEDY_END_LIMIT)
+			{
+				if (!Players[Current].IsLimited())
+					// We're not limited, so we can't end the limit
+					return false;
+			}
+			else
+			{
+				if (TopCardType == CARD_HAZARD)
+				{
+					if (Players[Current].HasSafety(Card::GetMatchingSafety(TopCard)))
+						// Remedy is superfluous; we already have the safety
+						return false;
+				}
+				else
+					// Other remedies can only be played on top of hazards
+					return false;
+
+				if (TopCard != (Value - 5))
+					// The remedy does not match the hazard
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	if (Type == CARD_SAFETY)
+		// There are no restrictions on playing safeties.
+		return true;
+
+	// Default to false. We should never get here unless something went horribly wrong.
+	return false;
+}
+
+bool	Engine::IsValidPlay		(Uint8 Index)						const
+{
+	if (Index >= HAND_SIZE)
+		return false;
+
+	return IsValidCard(Players[Current].GetValue(Index));
+}
+
+Uint8	Engine::KnownCards		(Uint8 Value)						const
+{
+	// On the table, in the discard pile, or in our own hand
+	return ExposedCards[Value] + InHand(Value);
+}
+
+bool	Engine::MayHaveRoW		(Uint8 PlayerIndex)								const
+{
+	if (Players[PlayerIndex].HasSafety(CARD_SAFETY_RIGHT_OF_WAY))
+		return true;
+	else if (CouldHoldCard(PlayerIndex, CARD_SAFETY_RIGHT_OF_WAY))
+		return true;
+
+	return false;
+}
+
+bool	Engine::OnMove			(Uint8 Move)
+{
+	if (Move < DISCARD_OFFSET)
+		return Play(Move);
+	else if (Move < MOVE_COUNT)
+		return Discard(Move - DISCARD_OFFSET);
+
+	return false;
+}
+
+void	Engine::OnPlay			(Uint8 Index, bool PlayerChange)
+{
+	// DiscardedCard places the correct card on top of the discard pile after a Coup Fourre.
+	Uint8 DiscardedCard = CARD_NULL_NULL;
+
+	if (IsValidPlay(Index))
+	{
+		Uint8	Type = Players[Current].GetType(Index),
+				Value = Players[Current].GetValue(Index);
+
+		if ((Type == CARD_MILEAGE) || (Type == CARD_REMEDY) || (Type == CARD_SAFETY))
+			DiscardedCard = Players[Current].OnPlay(Index);
+		else
+			Players[1 - Current].ReceiveHazard(Value);
+
+		// We "discard" after playing, but the card doesn't actually go to the discard pile.
+		Players[Current].Discard(Index);
+
+		if ((Type != CARD_SAFETY) && PlayerChange)
+			ChangePlayer();
+		else	//Playing a safety gives us another turn.
+		{
+			if (DiscardedCard != CARD_NULL_NULL)
+			{
+				// A Coup Fourre bounced a card off the player's tableau. Put it on
+				// the discard pile
+				Animate(0, ANIMATION_COUP_FOURRE_BOUNCE, DiscardedCard);
+				DiscardTop = DiscardedCard;
+			}
+
+			// We immediately draw another card after playing a safety.
+			Players[Current].Draw(&SourceDeck);
+		}
+
+		if (Value < CARD_NULL_NULL)
+			++ExposedCards[Value];
+	}
+}
+
+void	Engine::Pack			(GameState &State)				const
+{
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		Players[i].Pack(State.Players[i]);
+		State.RunningScores[i] = RunningScores[i];
+	}
+
+	State.ExposedCards[CARD_NULL_NULL / 2] = 0;
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		SetNibble(State.ExposedCards, i, ExposedCards[i]);
+
+	State.CardsLeft = SourceDeck.CardsLeft();
+	State.Current = Current;
+	State.DiscardTop = DiscardTop;
+	State.Flags = 0;
+
+	if (Extended)
+		State.Flags |= GAMESTATE_EXTENDED;
+	if (ExtensionDeclined)
+		State.Flags |= GAMESTATE_EXTENSION_DECLINED;
+}
+
+bool	Engine::Play			(Uint8 Index)
+{
+	Uint8	QualifiedCoupFourre	= Players[Current].GetQualifiedCoupFourre(),
+			TopCard				= Players[Current].GetTopCard(),
+			TopCardType			= Card::GetTypeFromValue(TopCard),
+			Type				= Players[Current].GetType(Index),
+			Value				= Players[Current].GetValue(Index);
+
+	bool	EarlyPlay	= false,
+			HasRoW		= Players[Current].HasSafety(CARD_SAFETY_RIGHT_OF_WAY);
+
+	if (IsValidPlay(Index))
+	{
+		if (Observing)
+			Observe(Value, false);
+		Animate(Index, ANIMATION_PLAY);
+		if (HasRoW && (Type == CARD_REMEDY))
+		{
+			EarlyPlay = true;
+			OnPlay(Index, false);
+		}
+		else if ((Type == CARD_SAFETY) && (Value != CARD_SAFETY_RIGHT_OF_WAY) && (Value == Card::GetMatchingSafety(TopCard)) && (Value != Card::GetMatchingSafety(QualifiedCoupFourre)))
+		{
+			EarlyPlay = true;
+			OnPlay(Index, false);
+			Animate(0, ANIMATION_SAFETY_SPAWN, TopCard + 5);
+		}
+
+		Players[Current].UpdateTopCard(false, false);
+
+		TopCard = Players[Current].GetTopCard();
+
+		if (HasRoW || (Value == CARD_SAFETY_RIGHT_OF_WAY))
+		{
+			if (Value == CARD_SAFETY_RIGHT_OF_WAY)
+			{
+				EarlyPlay = true;
+				OnPlay(Index, false);
+			}
+
+			if (Players[Current].IsRolling() && (TopCard != CARD_REMEDY_ROLL) && (QualifiedCoupFourre != CARD_HAZARD_STOP))
+			{
+				Animate(0, ANIMATION_SAFETY_SPAWN, CARD_REMEDY_ROLL);
+			}
+			
+			Players[Current].UpdateTopCard(true, false);
+
+			if ((Players[Current].GetTopCard(true) == CARD_HAZARD_SPEED_LIMIT) && (QualifiedCoupFourre != CARD_HAZARD_SPEED_LIMIT))
+			{
+				Animate(0, ANIMATION_SAFETY_SPAWN, CARD_REMEDY_END_LIMIT);
+			}
+
+			Players[Current].UpdateTopCard(true, true);
+		}
+		Players[Current].UnPop(Index);
+
+		if (HasRoW && (Type == CARD_REMEDY))
+			ChangePlayer();
+
+		if (!EarlyPlay)
+			OnPlay(Index);
+
+		return true;
+	}
+
+	return false;
+}
+
+void	Engine::Redeal			(Uint8 PlayerIndex, const Uint8 *Cards, const Uint8 *DeckOrder, Uint8 DeckCount)
+{
+	/*	Swaps in a different hand for one player and restacks the draw pile. The caller is
+		responsible for keeping the cards consistent with ExposedCards and the other hand. */
+	Players[PlayerIndex].GetHand().UnPack(Cards);
+	Beliefs[PlayerIndex].Reset();
+	SourceDeck.Arrange(DeckOrder, DeckCount);
+}
+
+bool	Engine::Reset			(void)
+{
+	bool NewGame = true;
+
+	SourceDeck.Shuffle();
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		RunningScores[i] += Scores[i]; //Roll up score
+		Scores[i] = 0;
+		
+		for (int j = 0; j < SCORE_CATEGORY_COUNT; ++j)
+			ScoreBreakdown[i][j] = 0;
+
+		if (RunningScores[i] != 0)
+			NewGame = false;
+	}
+
+	//Reset running scores if the round is over
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		if (RunningScores[i] >= 5000)
+		{
+			for (int j = 0; j < PLAYER_COUNT; ++j)
+				RunningScores[j] = 0;
+
+			NewGame = true;
+
+			break;
+		}
+	}
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		ExposedCards[i] = 0;
+
+	Extended = false;
+	ExtensionDeclined = false;
+
+	Current = 0;
+
+	DiscardTop = CARD_NULL_NULL;
+
+	//Reset down the chain
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		Players[i].Reset();
+		Beliefs[i].Reset();
+	}
+
+	Deal();
+
+	return NewGame;
+}
+
+void	Engine::UnPack			(const GameState &State)
+{
+	Uint8	Remaining[CARD_NULL_NULL];
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+	{
+		ExposedCards[i] = GetNibble(State.ExposedCards, i);
+		Remaining[i] = EXISTING_CARDS[i] - ExposedCards[i];
+	}
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		Players[i].UnPack(State.Players[i]);
+		Beliefs[i].Reset();	// A snapshot carries no history to read
+		RunningScores[i] = State.RunningScores[i];
+		Scores[i] = 0;
+
+		for (int j = 0; j < SCORE_CATEGORY_COUNT; ++j)
+			ScoreBreakdown[i][j] = 0;
+
+		// Whatever isn't exposed or in a hand is still in the deck
+		for (int j = 0; j < HAND_SIZE; ++j)
+		{
+			Uint8	Value = Players[i].GetValue(j);
+
+			if (Value < CARD_NULL_NULL)
+				--Remaining[Value];
+		}
+	}
+
+	SourceDeck.Rebuild(Remaining);
+
+	Current = State.Current;
+	DiscardTop = State.DiscardTop;
+	Extended = (State.Flags & GAMESTATE_EXTENDED) != 0;
+	ExtensionDeclined = (State.Flags & GAMESTATE_EXTENSION_DECLINED) != 0;
+}
+
+/* Protected methods */
+
+void	Engine::Deal			(void)
+{
+	for (int i = 0; i < 13; ++i) //Staggered deal
+		Players[i % 2].Draw(&SourceDeck);
+}
+
+void	Engine::GetDecisionKey	(DecisionKey &Key)			const
+{
+	/*	Packs what ComputerWeighMove reads. Mileage is kept in 25-mile units and the exposed
+		counts in nibbles. Its judgments about the opponent's hand are too slow to make here,
+		so the key holds what they are made from instead: the opponent's card count and the
+		belief about their hand. Whether the opponent is one card from home also turns on
+		their 200s, so those are counted too. */
+	const Player	&Mine = Players[Current],
+					&Theirs = Players[1 - Current];
+	Uint8			*Bytes = Key.Bytes;
+	Uint32			Fingerprint = Weights[Current]->GetFingerprint();
+
+	memset(Bytes, 0, DECISION_KEY_SIZE);
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+		Bytes[i] = Mine.GetValue(i);
+	std::sort(Bytes, Bytes + HAND_SIZE);
+
+	Bytes[7] = Mine.GetTopCard();
+	Bytes[8] = Mine.GetTopCard(true);
+	Bytes[10] = Mine.GetMileage() / 25;
+	Bytes[11] = Mine.GetPileCount(CARD_MILEAGE_200);
+	Bytes[12] = Mine.GetQualifiedCoupFourre();
+	Bytes[13] = Theirs.GetTopCard();
+	Bytes[14] = Theirs.GetTopCard(true);
+	Bytes[16] = Theirs.GetMileage() / 25;
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (Mine.HasSafety(i + SAFETY_OFFSET))
+			Bytes[9] |= 1 << i;
+		if (Theirs.HasSafety(i + SAFETY_OFFSET))
+			Bytes[15] |= 1 << i;
+	}
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Bytes[17 + (i >> 1)] |= ExposedCards[i] << ((i & 1) * 4);
+
+	Bytes[27] = SourceDeck.CardsLeft();
+
+	// Whatever the opponent might hold follows from these and the counts above
+	Bytes[28] = (Extended ? 1 : 0) | (Theirs.CardsInHand() << 1) | (Theirs.GetPileCount(CARD_MILEAGE_200) << 4);
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Bytes[29 + i] = Beliefs[1 - Current].GetLikelihood(i);
+
+	for (int i = 0; i < 4; ++i)
+		Bytes[48 + i] = (Fingerprint >> (i * 8)) & 0xFF;
+}
+
+void	Engine::NewGame			(void)
+{
+	Current = 0;	// Set current player to Player 1
+
+	Extended = false;
+	ExtensionDeclined = false;
+
+	DiscardTop = CARD_NULL_NULL;
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		ExposedCards[i] = 0;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		// Initialize scores to zero
+		Scores[i] = 0;
+		RunningScores[i] = 0;
+
+		Beliefs[i].Reset();
+
+		for (int j = 0; j < SCORE_CATEGORY_COUNT; ++j)
+			ScoreBreakdown[i][j] = 0;
+	}
+
+	Deal();
+}
+
+void	Engine::Observe			(Uint8 Value, bool Discarding)
+{
+	/*	Called before the current player's play or discard takes effect, to update what
+		their opponent believes about the rest of their hand. Each inference assumes the
+		player would have done the obvious thing if they could. */
+	HandBelief	&Belief = Beliefs[Current];
+	Uint8		Type = Card::GetTypeFromValue(Value),
+				Safety = Card::GetMatchingSafety(Players[Current].GetQualifiedCoupFourre()),
+				Needed;
+
+	Belief.Relax();
+
+	if ((Safety < CARD_NULL_NULL) && (Value != Safety))
+		// Passed up a coup fourre
+		Belief.Weaken(Safety, BELIEF_NO_COUP_FOURRE);
+
+	if (Discarding)
+	{
+		// Discarding says they had nothing worth playing
+		for (int i = 0; i < CARD_NULL_NULL; ++i)
+		{
+			if ((Card::GetTypeFromValue(i) != CARD_SAFETY) && IsValidCard(i))
+				Belief.Weaken(i, BELIEF_DISCARDED);
+		}
+	}
+	else if (Type == CARD_SAFETY)
+		return;
+	else if (!Players[Current].IsRolling())
+	{
+		// Stopped, and didn't fix it
+		Needed = Players[Current].GetTopCard();
+		Needed = (Card::GetTypeFromValue(Needed) == CARD_HAZARD) ? (Needed + 5) : CARD_REMEDY_ROLL;
+
+		if ((Value != Needed) && IsValidCard(Needed))
+			Belief.Weaken(Needed, BELIEF_UNREMEDIED);
+	}
+	else if (Type != CARD_MILEAGE)
+	{
+		// Rolling, and didn't move
+		for (int i = CARD_MILEAGE_25; i <= CARD_MILEAGE_200; ++i)
+		{
+			if (IsValidCard(i))
+				Belief.Weaken(i, BELIEF_NO_MILEAGE);
+		}
+	}
+}
+
+}
@@ -0,0 +1,184 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_ENGINE_H
+#define	_SDLMILLE_ENGINE_H
+
+#include "Belief.h"
+#include "DecisionCache.h"
+#include "GameState.h"
+#include "Player.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "Weights.h"
+#include <algorithm>
+
+namespace _SDLMille
+{
+
+enum	{ANIMATION_PLAY = 0, ANIMATION_DISCARD, ANIMATION_RETURN, ANIMATION_COUP_FOURRE_BOUNCE, ANIMATION_SAFETY_SPAWN, ANIMATION_INVALID};
+
+enum	{DIFFICULTY_EASY = 0, DIFFICULTY_NORMAL, DIFFICULTY_HARD, DIFFICULTY_EXPERT, DIFFICULTY_LEVEL_COUNT};
+
+const	char	DIFFICULTY_TEXT[DIFFICULTY_LEVEL_COUNT][7] = {"Easy", "Normal", "Hard", "Expert"};
+
+const Uint8	PLAYER_COUNT = 2,
+			SCORE_CATEGORY_COUNT = 12,
+			DISCARD_OFFSET = HAND_SIZE,	// Moves 0-6 play a card from the hand, 7-13 discard one
+			MOVE_COUNT = HAND_SIZE * 2,
+			MOVE_NONE = 0xFF;
+
+/*	The rules of the game, with no dependence on SDL. Game derives from this and adds the
+	presentation; millesim drives it directly. Engine holds its deck by value, so a copy of
+	an Engine is a complete, independent game that can be played forward. */
+
+class Engine
+{
+public:
+				Engine			(void);
+	explicit	Engine			(Uint64 Seed);
+	virtual		~Engine			(void)								{}
+	void		ChangePlayer	(void);
+	bool		ComputerChooseExtension	(Uint8 Level, Uint32 Milliseconds = 0)	const;
+	bool		ComputerDecideExtension	(void)				const;
+	Uint8		ComputerMove	(void)						const;
+	Uint8		ComputerSmartMove	(void)					const;
+	Uint8		ComputerChooseMove	(Uint8 Level, Uint32 Milliseconds = 0)	const;
+	bool		CouldHoldCard	(Uint8 PlayerIndex, Uint8 Value)	const;
+	bool		Discard			(Uint8 Index);
+	bool		EndOfGame		(void)						const;
+	void		Extend			(bool Extending);
+	int			GetCardsLeft	(void)						const;
+	Uint8		GetCurrent		(void)						const;
+	Uint64		GetHash			(void)						const;
+	double		GetHoldProbability	(Uint8 PlayerIndex, Uint8 Value)	const;
+	Uint8		GetOutcome		(void)						const;
+	const Player &	GetPlayer	(Uint8 PlayerIndex)			const;
+	int			GetRunningScore	(Uint8 PlayerIndex)			const;
+	int			GetScore		(Uint8 PlayerIndex)			const;
+	Uint64		GetSeed			(void)						const;
+	void		GetScores		(void);
+	Uint8		InHand			(Uint8 Value)				const;
+	bool		IsExtensionPending	(void)					const;
+	bool		IsHandOver		(void)						const;
+	bool		IsOneCardAway	(Uint8 PlayerIndex)			const;
+	bool		IsValidCard		(Uint8 Value)				const;
+	bool		IsValidPlay		(Uint8 Index)				const;
+	Uint8		KnownCards		(Uint8 Value)				const;
+	bool		MayHaveRoW		(Uint8 PlayerIndex)			const;
+	bool		OnMove			(Uint8 Move);
+	void		OnPlay			(Uint8 Index, bool PlayerChange = true);
+	void		Pack			(GameState &State)			const;
+	bool		Play			(Uint8 Index);
+	void		Redeal			(Uint8 PlayerIndex, const Uint8 *Cards, const Uint8 *DeckOrder, Uint8 DeckCount);
+	bool		Reset			(void);
+	void		SetCache		(DecisionCache *NewCache);
+	void		SetObserving	(bool NewObserving);
+	void		SetTrace		(DecisionTrace *NewTrace);
+	void		SetWeights		(Uint8 PlayerIndex, const WeightTable *Table);
+	void		UnPack			(const GameState &State);
+	Uint8		UnknownCards	(Uint8 Value)				const;
+protected:
+	/* Methods */
+	virtual	void	Animate		(Uint8 /*Index*/, Uint8 /*AnimationType*/, Uint8 /*Value*/ = CARD_NULL_NULL)	{}
+	Uint8		ComputerWeighMove	(void)					const;
+	void		Deal			(void);
+	void		GetDecisionKey	(DecisionKey &Key)			const;
+	void		NewGame			(void);
+	void		Observe			(Uint8 Value, bool Discarding);
+
+	/* Properties */
+	Player		Players[PLAYER_COUNT];
+	HandBelief	Beliefs[PLAYER_COUNT];	// What each player's moves have given away about their hand
+	Deck		SourceDeck;
+	int			Scores[PLAYER_COUNT],
+				RunningScores[PLAYER_COUNT],
+				ScoreBreakdown[PLAYER_COUNT][SCORE_CATEGORY_COUNT];
+	bool		Extended, ExtensionDeclined,
+				Observing;				// Whether plays update Beliefs; copies inherit it
+	Uint8		Current,				// Index of current player
+				DiscardTop,
+				ExposedCards[CARD_NULL_NULL];
+	const WeightTable	*Weights[PLAYER_COUNT];	// What ComputerSmartMove weighs each player's cards with
+	DecisionCache	*Cache;		// Where ComputerSmartMove remembers its decisions, if anywhere; copies share it
+	mutable	Uint8	CacheSample;	// Counts decisions down to the next one that is timed for the cache
+	DecisionTrace	*Trace;		// Where ComputerSmartMove explains itself, if anywhere; copies share it
+};
+
+inline	int			Engine::GetCardsLeft	(void)					const
+{
+	return SourceDeck.CardsLeft();
+}
+
+inline	Uint8		Engine::GetCurrent		(void)					const
+{
+	return Current;
+}
+
+inline	const Player &	Engine::GetPlayer	(Uint8 PlayerIndex)		const
+{
+	return Players[PlayerIndex];
+}
+
+inline	int			Engine::GetRunningScore	(Uint8 PlayerIndex)		const
+{
+	return RunningScores[PlayerIndex];
+}
+
+inline	int			Engine::GetScore		(Uint8 PlayerIndex)		const
+{
+	return Scores[PlayerIndex];
+}
+
+inline	Uint64		Engine::GetSeed			(void)					const
+{
+	return SourceDeck.GetSeed();
+}
+
+inline	void		Engine::SetCache		(DecisionCache *NewCache)
+{
+	// The cache locks for itself, so any number of threads may share one
+	Cache = NewCache;
+}
+
+inline	void		Engine::SetObserving	(bool NewObserving)
+{
+	Observing = NewObserving;
+}
+
+inline	void		Engine::SetTrace		(DecisionTrace *NewTrace)
+{
+	// A trace has no locks, so only the thread that owns it may play with this Engine or its copies
+	Trace = NewTrace;
+}
+
+inline	void		Engine::SetWeights		(Uint8 PlayerIndex, const WeightTable *Table)
+{
+	Weights[PlayerIndex] = (Table != 0) ? Table : &WeightTable::GetDefault();
+}
+
+inline	Uint8		Engine::UnknownCards	(Uint8 Value)			const
+{
+	return (EXISTING_CARDS[Value] - KnownCards(Value));
+}
+
+}
+
+#endif
@@ -0,0 +1,344 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+
+#include "Evaluator.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define	EVALUATOR_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define	EVALUATOR_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define	EVALUATOR_NEON
+#endif
+
+namespace _SDLMille
+{
+
+namespace
+{
+
+const	Uint8	FEATURES_PER_SIDE = MILEAGE_PILES + 1 + (CARD_NULL_NULL + 1) + 1 + SAFETY_COUNT * 2,
+				FEATURE_SHARED = FEATURES_PER_SIDE * 2,
+				FEATURE_EXPOSED = FEATURE_SHARED,
+				FEATURE_HAND = FEATURE_EXPOSED + CARD_NULL_NULL,
+				FEATURE_CARDS_LEFT = FEATURE_HAND + CARD_NULL_NULL,
+				FEATURE_OPPONENT_HAND = FEATURE_CARDS_LEFT + 1,
+				FEATURE_EXTENDED = FEATURE_OPPONENT_HAND + 1,
+				FEATURE_TO_MOVE = FEATURE_EXTENDED + 1,
+				FEATURE_COUP_FOURRE = FEATURE_TO_MOVE + 1,
+				FEATURE_COUNT = FEATURE_COUP_FOURRE + 1;
+
+// Fails to compile if the features outgrow the padded input layer
+typedef	char	FeatureCountCheck[(FEATURE_COUNT <= EVALUATOR_INPUTS) ? 1 : -1];
+
+/*	The three inner loops, each over EVALUATOR_HIDDEN floats: add a scaled row of weights to
+	the sums, clamp the sums at zero, and take a dot product. */
+
+#if defined(EVALUATOR_AVX2)
+
+const char	*KERNEL_NAME = "AVX2";
+
+inline	void	AddScaled	(float *Sums, const float *Row, float Scale)
+{
+	__m256	Factor = _mm256_set1_ps(Scale);
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 8)
+		_mm256_storeu_ps(Sums + i, _mm256_fmadd_ps(_mm256_loadu_ps(Row + i), Factor, _mm256_loadu_ps(Sums + i)));
+}
+
+inline	void	Rectify		(float *Sums)
+{
+	__m256	Zero = _mm256_setzero_ps();
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 8)
+		_mm256_storeu_ps(Sums + i, _mm256_max_ps(_mm256_loadu_ps(Sums + i), Zero));
+}
+
+inline	float	Dot			(const float *Left, const float *Right)
+{
+	__m256	Total = _mm256_setzero_ps();
+	__m128	Half;
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 8)
+		Total = _mm256_fmadd_ps(_mm256_loadu_ps(Left + i), _mm256_loadu_ps(Right + i), Total);
+
+	Half = _mm_add_ps(_mm256_castps256_ps128(Total), _mm256_extractf128_ps(Total, 1));
+	Half = _mm_add_ps(Half, _mm_movehl_ps(Half, Half));
+	Half = _mm_add_ss(Half, _mm_shuffle_ps(Half, Half, 1));
+
+	return _mm_cvtss_f32(Half);
+}
+
+#elif defined(EVALUATOR_SSE2)
+
+const char	*KERNEL_NAME = "SSE2";
+
+inline	void	AddScaled	(float *Sums, const float *Row, float Scale)
+{
+	__m128	Factor = _mm_set1_ps(Scale);
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		_mm_storeu_ps(Sums + i, _mm_add_ps(_mm_loadu_ps(Sums + i), _mm_mul_ps(_mm_loadu_ps(Row + i), Factor)));
+}
+
+inline	void	Rectify		(float *Sums)
+{
+	__m128	Zero = _mm_setzero_ps();
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		_mm_storeu_ps(Sums + i, _mm_max_ps(_mm_loadu_ps(Sums + i), Zero));
+}
+
+inline	float	Dot			(const float *Left, const float *Right)
+{
+	__m128	Total = _mm_setzero_ps();
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		Total = _mm_add_ps(Total, _mm_mul_ps(_mm_loadu_ps(Left + i), _mm_loadu_ps(Right + i)));
+
+	Total = _mm_add_ps(Total, _mm_movehl_ps(Total, Total));
+	Total = _mm_add_ss(Total, _mm_shuffle_ps(Total, Total, 1));
+
+	return _mm_cvtss_f32(Total);
+}
+
+#elif defined(EVALUATOR_NEON)
+
+const char	*KERNEL_NAME = "NEON";
+
+inline	void	AddScaled	(float *Sums, const float *Row, float Scale)
+{
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		vst1q_f32(Sums + i, vmlaq_n_f32(vld1q_f32(Sums + i), vld1q_f32(Row + i), Scale));
+}
+
+inline	void	Rectify		(float *Sums)
+{
+	float32x4_t	Zero = vdupq_n_f32(0);
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		vst1q_f32(Sums + i, vmaxq_f32(vld1q_f32(Sums + i), Zero));
+}
+
+inline	float	Dot			(const float *Left, const float *Right)
+{
+	float32x4_t	Total = vdupq_n_f32(0);
+	float32x2_t	Half;
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; i += 4)
+		Total = vmlaq_f32(Total, vld1q_f32(Left + i), vld1q_f32(Right + i));
+
+	Half = vadd_f32(vget_low_f32(Total), vget_high_f32(Total));
+	Half = vpadd_f32(Half, Half);
+
+	return vget_lane_f32(Half, 0);
+}
+
+#else
+
+const char	*KERNEL_NAME = "scalar";
+
+inline	void	AddScaled	(float *Sums, const float *Row, float Scale)
+{
+	for (int i = 0; i < EVALUATOR_HIDDEN; ++i)
+		Sums[i] += Row[i] * Scale;
+}
+
+inline	void	Rectify		(float *Sums)
+{
+	for (int i = 0; i < EVALUATOR_HIDDEN; ++i)
+	{
+		if (Sums[i] < 0)
+			Sums[i] = 0;
+	}
+}
+
+inline	float	Dot			(const float *Left, const float *Right)
+{
+	float	Total = 0;
+
+	for (int i = 0; i < EVALUATOR_HIDDEN; ++i)
+		Total += Left[i] * Right[i];
+
+	return Total;
+}
+
+#endif
+
+bool	ReadFloats	(FILE *WeightFile, float *Values, int Count)
+{
+	for (int i = 0; i < Count; ++i)
+	{
+		if (fscanf(WeightFile, "%f", &Values[i]) != 1)
+			return false;
+	}
+
+	return true;
+}
+
+void	GetSideFeatures	(const PlayerState &Side, bool Extended, float *Features)
+{
+	const TableauState	&Table = Side.Table;
+	int		Mileage = 0;
+	Uint8	Count;
+
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+	{
+		Count = GetNibble(Table.Piles, i);
+		Mileage += Count * Card::GetMileValue(MILEAGE_OFFSET + i);
+		Features[i] = (float) Count / MAX_CARD_COUNT[i];
+	}
+	Features += MILEAGE_PILES;
+
+	*Features++ = (float) (((Extended) ? 1000 : 700) - Mileage) / 1000;
+
+	if (Table.TopCard <= CARD_NULL_NULL)
+		Features[Table.TopCard] = 1;
+	Features += CARD_NULL_NULL + 1;
+
+	*Features++ = ((Table.LimitCard == CARD_HAZARD_SPEED_LIMIT) && !(Table.Safeties & (1 << (CARD_SAFETY_RIGHT_OF_WAY - SAFETY_OFFSET)))) ? 1.0f : 0.0f;
+
+	for (int i = 0; i < SAFETY_COUNT * 2; ++i)
+		Features[i] = (Table.Safeties & (1 << i)) ? 1.0f : 0.0f;
+}
+
+}
+
+/* Public methods */
+
+		PositionEvaluator::PositionEvaluator	(void)
+{
+	memset(Bias1, 0, sizeof(Bias1));
+	memset(Bias2, 0, sizeof(Bias2));
+	memset(Layer1, 0, sizeof(Layer1));
+	memset(Layer2, 0, sizeof(Layer2));
+	memset(Layer3, 0, sizeof(Layer3));
+	Bias3 = 0;
+
+	Loaded = false;
+}
+
+double	PositionEvaluator::Evaluate		(const Engine &Position, Uint8 PlayerIndex)		const
+{
+	GameState	State;
+
+	Position.Pack(State);
+
+	return Evaluate(State, PlayerIndex);
+}
+
+double	PositionEvaluator::Evaluate		(const GameState &State, Uint8 PlayerIndex)		const
+{
+	float	Features[EVALUATOR_INPUTS],
+			Hidden1[EVALUATOR_HIDDEN],
+			Hidden2[EVALUATOR_HIDDEN];
+
+	if (!Loaded)
+		return 0;
+
+	GetFeatures(State, PlayerIndex, Features);
+
+	// Most features are zero, so only the rows of the ones that aren't get added in
+	memcpy(Hidden1, Bias1, sizeof(Hidden1));
+	for (int i = 0; i < FEATURE_COUNT; ++i)
+	{
+		if (Features[i] != 0)
+			AddScaled(Hidden1, Layer1[i], Features[i]);
+	}
+	Rectify(Hidden1);
+
+	memcpy(Hidden2, Bias2, sizeof(Hidden2));
+	for (int i = 0; i < EVALUATOR_HIDDEN; ++i)
+	{
+		if (Hidden1[i] != 0)
+			AddScaled(Hidden2, Layer2[i], Hidden1[i]);
+	}
+	Rectify(Hidden2);
+
+	return Dot(Hidden2, Layer3) + Bias3;
+}
+
+void	PositionEvaluator::GetFeatures	(const GameState &State, Uint8 PlayerIndex, float *Features)
+{
+	const PlayerState	&Own = State.Players[PlayerIndex],
+						&Opponent = State.Players[1 - PlayerIndex];
+	bool	Extended = (State.Flags & GAMESTATE_EXTENDED) != 0;
+	Uint8	OpponentCards = 0;
+
+	memset(Features, 0, sizeof(float) * EVALUATOR_INPUTS);
+
+	GetSideFeatures(Own, Extended, Features);
+	GetSideFeatures(Opponent, Extended, Features + FEATURES_PER_SIDE);
+
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+		Features[FEATURE_EXPOSED + i] = (float) GetNibble(State.ExposedCards, i) / EXISTING_CARDS[i];
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (Own.Cards[i] < CARD_NULL_NULL)
+			Features[FEATURE_HAND + Own.Cards[i]] += 1.0f / HAND_SIZE;
+		if (Opponent.Cards[i] < CARD_NULL_NULL)
+			++OpponentCards;
+	}
+
+	Features[FEATURE_CARDS_LEFT] = (float) State.CardsLeft / DECK_SIZE;
+	Features[FEATURE_OPPONENT_HAND] = (float) OpponentCards / HAND_SIZE;
+	Features[FEATURE_EXTENDED] = (Extended) ? 1.0f : 0.0f;
+	Features[FEATURE_TO_MOVE] = (State.Current == PlayerIndex) ? 1.0f : 0.0f;
+	Features[FEATURE_COUP_FOURRE] = (Own.QualifiedCoupFourre < CARD_NULL_NULL) ? 1.0f : 0.0f;
+}
+
+const char *	PositionEvaluator::GetKernelName	(void)
+{
+	return KERNEL_NAME;
+}
+
+bool	PositionEvaluator::Load			(const char *Path)
+{
+	FILE	*WeightFile = fopen(Path, "r");
+	char	Magic[5];
+	int		Inputs, Hidden1, Hidden2;
+	bool	Success;
+
+	if (WeightFile == 0)
+		return false;
+
+	Success = (fscanf(WeightFile, "%4s %d %d %d", Magic, &Inputs, &Hidden1, &Hidden2) == 4) && (strcmp(Magic, "MLP1") == 0)
+		&& (Inputs == EVALUATOR_INPUTS) && (Hidden1 == EVALUATOR_HIDDEN) && (Hidden2 == EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, &Layer1[0][0], EVALUATOR_INPUTS * EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, Bias1, EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, &Layer2[0][0], EVALUATOR_HIDDEN * EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, Bias2, EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, Layer3, EVALUATOR_HIDDEN)
+		&& ReadFloats(WeightFile, &Bias3, 1);
+
+	fclose(WeightFile);
+	Loaded = Success;
+
+	return Success;
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_EVALUATOR_H
+#define	_SDLMILLE_EVALUATOR_H
+
+#include "Engine.h"
+
+namespace _SDLMille
+{
+
+const	Uint8	EVALUATOR_INPUTS = 120,	// Feature vector length, padded to a multiple of 8
+				EVALUATOR_HIDDEN = 32;	// Units in each of the two hidden layers
+
+/*	A small neural network that scores a position without playing it out: the features below
+	go through two hidden layers of rectified units to one linear output, the expected hand
+	score margin (the viewer's hand score less the opponent's). Search uses it in place of
+	rollouts when one is loaded, and anything holding an Engine can ask it for a value.
+
+	Only what the viewer can see goes in: both tableaus (mileage piles, distance remaining,
+	top card, limits, safeties and Coup Fourres), the viewer's own hand, ExposedCards, the
+	cards left in the deck, the size of the opponent's hand and whose turn it is. Every
+	feature is scaled to roughly 0..1 and most are zero, so the first layer adds one row of
+	weights per non-zero input rather than multiplying out the whole matrix.
+
+	The inner loops are written for AVX2, SSE2 or NEON, whichever the compiler targets, with
+	a plain C++ fallback. Weights are a text file: "MLP1 120 32 32", then the first layer's
+	weights input by input (32 per input), its 32 biases, the second layer's weights the same
+	way, its biases, the 32 output weights and the output bias. */
+
+class PositionEvaluator
+{
+public:
+				PositionEvaluator	(void);
+	double		Evaluate		(const Engine &Position, Uint8 PlayerIndex)		const;
+	double		Evaluate		(const GameState &State, Uint8 PlayerIndex)		const;
+	bool		IsLoaded		(void)											const;
+	bool		Load			(const char *Path);
+
+	static	void		GetFeatures		(const GameState &State, Uint8 PlayerIndex, float *Features);
+	static	const char *	GetKernelName	(void);
+private:
+	float		Bias1[EVALUATOR_HIDDEN],
+				Bias2[EVALUATOR_HIDDEN],
+				Bias3,
+				Layer1[EVALUATOR_INPUTS][EVALUATOR_HIDDEN],
+				Layer2[EVALUATOR_HIDDEN][EVALUATOR_HIDDEN],
+				Layer3[EVALUATOR_HIDDEN];
+	bool		Loaded;
+};
+
+inline	bool	PositionEvaluator::IsLoaded	(void)						const
+{
+	return Loaded;
+}
+
+}
+
+#endif
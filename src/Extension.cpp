@@ -0,0 +1,171 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Extension.h"
+#include <math.h>
+
+namespace _SDLMille
+{
+
+Uint8	ExtensionEvaluator::DefaultThreadCount = 0;	// One per processor
+
+		ExtensionEvaluator::ExtensionEvaluator	(void)
+{
+	SetThreadCount((DefaultThreadCount > 0) ? DefaultThreadCount : Thread::GetProcessorCount());
+
+	Budget = 0;
+	Decider = 0;
+	Margin = 0;
+	MillisecondBudget = 0;
+	Rollouts = 0;
+	Start = 0;
+	Values[0] = Values[1] = 0;
+}
+
+bool	ExtensionEvaluator::Evaluate	(const Engine &Position, Uint8 PlayerIndex, Uint32 Milliseconds, Uint32 NewRollouts)
+{
+	Worker	*Workers;
+	Uint64	Seed = Position.GetHash();	// The same question gets the same answer
+	double	Difference, Squares = 0;
+
+	Rollouts = 0;
+	Margin = 0;
+	Values[0] = Values[1] = 0;
+
+	if (!Position.IsExtensionPending() || (NewRollouts == 0) || !View.Observe(Position, PlayerIndex))
+		return false;
+
+	Decider = PlayerIndex;
+	Budget = NewRollouts;
+	MillisecondBudget = Milliseconds;
+	Start = Thread::GetMilliseconds();
+
+	Workers = new Worker[ThreadCount];
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		Workers[i].Owner = this;
+		Workers[i].Generator.Seed(Random::Mix(Seed));
+		Workers[i].Rollouts = 0;
+		Workers[i].Totals[0] = Workers[i].Totals[1] = 0;
+		Workers[i].Squares = 0;
+	}
+
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Start(WorkerMain, &Workers[i]);
+
+	WorkerMain(&Workers[0]);
+
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Wait();
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		Rollouts += Workers[i].Rollouts;
+		Values[0] += Workers[i].Totals[0];
+		Values[1] += Workers[i].Totals[1];
+		Squares += Workers[i].Squares;
+	}
+
+	delete[] Workers;
+
+	if (Rollouts == 0)
+		return false;
+
+	Values[0] /= Rollouts;
+	Values[1] /= Rollouts;
+
+	Difference = Values[1] - Values[0];
+	Squares = (Squares / Rollouts) - (Difference * Difference);
+
+	if (Squares > 0)
+		Margin = EXTENSION_Z * sqrt(Squares / Rollouts);
+
+	return true;
+}
+
+void	ExtensionEvaluator::SetDefaultThreadCount	(Uint8 NewThreadCount)
+{
+	// Applies to every evaluator created afterwards; 0 is one thread per processor
+	DefaultThreadCount = NewThreadCount;
+}
+
+void	ExtensionEvaluator::SetThreadCount	(Uint8 NewThreadCount)
+{
+	if (NewThreadCount < 1)
+		ThreadCount = 1;
+	else if (NewThreadCount > EXTENSION_THREAD_MAX)
+		ThreadCount = EXTENSION_THREAD_MAX;
+	else
+		ThreadCount = NewThreadCount;
+}
+
+/* Private methods */
+
+int		ExtensionEvaluator::Rollout		(Engine &Position)		const
+{
+	Uint32	MoveCount = 0;
+
+	while (!Position.IsHandOver())
+	{
+		if (Position.IsExtensionPending())
+			Position.Extend(Position.ComputerDecideExtension());
+		else if (Position.GetPlayer(Position.GetCurrent()).IsOutOfCards())
+			Position.ChangePlayer();
+		else if (!Position.OnMove(Position.ComputerSmartMove()) || (++MoveCount > EXTENSION_ROLLOUT_LIMIT))
+			break;
+	}
+
+	Position.GetScores();
+
+	return Position.GetScore(Decider) - Position.GetScore(1 - Decider);
+}
+
+void	ExtensionEvaluator::WorkerMain	(void *Data)
+{
+	Worker				&Self = *((Worker *) Data);
+	ExtensionEvaluator	&Owner = *Self.Owner;
+	Uint32				Share = (Owner.Budget + Owner.ThreadCount - 1) / Owner.ThreadCount;
+	Engine				Deal(Self.Generator.Next());
+
+	while (Self.Rollouts < Share)
+	{
+		int		Scores[2];
+
+		if ((Owner.MillisecondBudget > 0) && ((Thread::GetMilliseconds() - Owner.Start) >= Owner.MillisecondBudget))
+			break;
+
+		Owner.View.Sample(Self.Generator, Deal);
+
+		for (int i = 0; i < 2; ++i)
+		{
+			Engine	Choice = Deal;
+
+			Choice.Extend(i == 1);
+			Scores[i] = Owner.Rollout(Choice);
+		}
+
+		Self.Totals[0] += Scores[0];
+		Self.Totals[1] += Scores[1];
+		Self.Squares += (double) (Scores[1] - Scores[0]) * (Scores[1] - Scores[0]);
+		++Self.Rollouts;
+	}
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_EXTENSION_H
+#define	_SDLMILLE_EXTENSION_H
+
+#include "Sampler.h"
+#include "Thread.h"
+
+namespace _SDLMille
+{
+
+const	Uint32	EXTENSION_ROLLOUTS = 2000,
+				EXTENSION_ROLLOUT_LIMIT = 1000;	// Moves; same guard as the simulator
+const	Uint8	EXTENSION_THREAD_MAX = 64;
+const	double	EXTENSION_Z = 1.96;
+
+/*	Weighs extending a completed trip against stopping, for whoever completed it. Each
+	rollout deals the cards that player can't see, then finishes the hand both ways with
+	ComputerSmartMove on both sides, so the 200 point bonus, the chance of being stopped short
+	of 1000 and the chance of the opponent catching up are all scored by GetScores. Both
+	choices see the same deals, and the values are hand score margins (the player's score
+	less the opponent's). Rollouts run on several threads at once and stop at the time limit
+	even if the count hasn't been reached. */
+
+class ExtensionEvaluator
+{
+public:
+				ExtensionEvaluator	(void);
+	bool		Evaluate		(const Engine &Position, Uint8 PlayerIndex, Uint32 Milliseconds, Uint32 Rollouts = EXTENSION_ROLLOUTS);
+	double		GetMargin		(void)					const;
+	Uint32		GetRollouts		(void)					const;
+	double		GetValue		(bool Extending)		const;
+	void		SetThreadCount	(Uint8 NewThreadCount);
+	bool		ShouldExtend	(void)					const;
+
+	static	void	SetDefaultThreadCount	(Uint8 NewThreadCount);
+private:
+	struct Worker
+	{
+		ExtensionEvaluator	*Owner;
+		Thread		Runner;
+		Random		Generator;
+		Uint32		Rollouts;
+		double		Totals[2],		// Indexed by whether the trip was extended
+					Squares;		// Of the difference extending made
+	};
+
+	int			Rollout			(Engine &Position)		const;
+
+	static	void	WorkerMain	(void *Data);
+
+	Uint8		Decider,
+				ThreadCount;
+	Uint32		Budget,
+				MillisecondBudget,
+				Rollouts,
+				Start;
+	double		Margin,
+				Values[2];
+	Sampler		View;
+
+	static	Uint8	DefaultThreadCount;
+};
+
+inline	double	ExtensionEvaluator::GetMargin	(void)				const
+{
+	return Margin;
+}
+
+inline	Uint32	ExtensionEvaluator::GetRollouts	(void)				const
+{
+	return Rollouts;
+}
+
+inline	double	ExtensionEvaluator::GetValue	(bool Extending)	const
+{
+	return Values[Extending ? 1 : 0];
+}
+
+inline	bool	ExtensionEvaluator::ShouldExtend	(void)			const
+{
+	return Values[1] > Values[0];
+}
+
+}
+
+#endif
@@ -23,37 +23,27 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #define	IN_DEMO ((Scene >= SCENE_LEARN_2) && (Scene <= SCENE_LEARN_7))
 #define IN_TUTORIAL ((Scene >= SCENE_LEARN_1) && (Scene <= SCENE_LEARN_7))
 
-#include "Player.h"
+#include "Engine.h"
+#include "HandView.h"
 #include "Options.h"
-#include "Stats.h"
-#include <algorithm>
+#include "Refiner.h"
+#include "TableauView.h"
 #include <cmath>
 
 namespace _SDLMille
 {
 
-enum	{ANIMATION_PLAY = 0, ANIMATION_DISCARD, ANIMATION_RETURN, ANIMATION_COUP_FOURRE_BOUNCE, ANIMATION_SAFETY_SPAWN, ANIMATION_INVALID};
-
-enum	{DIFFICULTY_EASY = 0, DIFFICULTY_NORMAL, DIFFICULTY_HARD, DIFFICULTY_LEVEL_COUNT};
-
 enum	{UPPER_LEFT = 0, BOTTOM_LEFT, UPPER_RIGHT, BOTTOM_RIGHT, CORNER_COUNT};
 
 const Uint8 CIRCLE_CLICK_PADDING = 3,
 			MENU_ITEM_COUNT = 5,
 			MENU_SURFACE_COUNT = STAT_CAPTIONS_SIZE,
-			PLAYER_COUNT = 2,
-			SCORE_CATEGORY_COUNT = 12,
 			SCORE_COLUMN_COUNT = 3,
 			MESSAGE_SIZE = 42;
 
-const	char	CARD_CAPTIONS[CARD_SAFETY_RIGHT_OF_WAY + 1][20] = {
-					"Crash HAZARD", "Fuel HAZARD", "Tire HAZARD", "Speed HAZARD", "Stop HAZARD",
-					"Crash REMEDY", "Fuel REMEDY", "Tire REMEDY", "Speed REMEDY", "Roll REMEDY",
-					"Crash SAFETY", "Fuel SAFETY", "Tire SAFETY", "Right-of-way SAFETY"	};
 const	int		HAND_COORDS[] =	{	146,
 									146,
 									3	};
-const	char	DIFFICULTY_TEXT[DIFFICULTY_LEVEL_COUNT][7] = {"Easy", "Normal", "Hard"};
 
 const	char	MENU_ITEM_NAMES[MENU_ITEM_COUNT][15] = {"Options", "Stats", "New game", "Reset Stats", "Main menu"};
 
@@ -73,7 +63,17 @@ const	char	VERSION_TEXT[] = "0.9.1 (1.0 HD Preview 1)";
 
 const	int		SAVE_FORMAT_VER = 8;
 
-class Game
+// How long each computer move is held back, in ms, and so how long the computer may think
+const	Uint32	GAME_PACE_FAST = 200,
+				GAME_PACE_NORMAL = 500,
+				GAME_ADVICE_TIME = 300,	// Most the extension advice spends on its rollouts
+				GAME_HINT_INTERVAL = 16,	// Deals between updates of the hint
+				GAME_HINT_ROUNDS = 2000;	// Deals before the hint is settled and the thread stops
+
+enum	{GAME_EVENT_COMPUTER_MOVE = 1, GAME_EVENT_HINT, GAME_EVENT_HINT_DONE,
+		GAME_EVENT_EXTENSION_ADVICE, GAME_EVENT_COMPUTER_EXTENSION};	// SDL_USEREVENT codes
+
+class Game : public Engine
 {
 public:
 				Game			(void);
@@ -81,38 +81,26 @@ public:
 	bool		OnExecute		(void);
 private:
 	/* Methods */
+	void		AdviseExtension	(void);
 	void		Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value = CARD_NULL_NULL);
 	//bool		AnimationRunning	(void)				const;
-	void		ChangePlayer	(void);
 	bool		CheckForChange	(Uint8 &Old, Uint8 &New);
 	//void		CheckTableau	(SDL_Surface *Target);
 	void		ClearMessage	(void);
-	bool		CouldHoldCard	(Uint8 PlayerIndex, Uint8 Value)	const;
-	bool		ComputerDecideExtension	(void)			const;
-	void		ComputerMove	(void);
-	void		ComputerSmartMove	(void);
-	void		DelayUntil		(Uint32 Ticks);
 	bool		Discard			(void);
-	bool		EndOfGame		(void)					const;
 	//void		FillBackDrop	(SDL_Surface *Target)	const;
 	Uint8		FindPopped		(void)					const;
-	void		GetScores		(void);
 	void		IgnoreEvents	(void);
 	bool		InDiscardPile	(int X, int Y)			const;
-	Uint8		InHand			(Uint8 Value)			const;
-	bool		IsOneCardAway	(Uint8 PlayerIndex)		const;
-	bool		IsValidPlay		(Uint8 Index)			const;
-	Uint8		KnownCards		(Uint8 Value)			const;
-	bool		MayHaveRoW		(Uint8 PlayerIndex)		const;
 	void		OnClick			(int X, int Y);
 	void		OnEvent			(SDL_Event * Event);
 	bool		OnInit			(void);
 	void		OnLoop			(void);
 	void		OnMouseUp		(int X, int Y);
-	void		OnPlay			(Uint8 Index, bool PlayerChange = true);
 	void		OnRender		(SDL_Surface *Target, bool Force = false, bool Flip = true);
 	void		OnRenderModal	(SDL_Surface *Target);
 	void		OnRenderScene	(SDL_Surface *Target);
+	void		PlayComputerMove	(void);
 	void		Pop				(Uint8 Index);
 	Uint32		Radius			(int X1, int Y1, int X2, int Y2);
 	void		Reset			(bool SaveStats = false);
@@ -123,11 +111,31 @@ private:
 	void		ShowLoading		(void);
 	void		ShowMessage		(const char * Msg, bool SetDirty = true);
 	bool		ShowModal		(Uint8 ModalName);
-	Uint8		UnknownCards	(Uint8 Value);
+	void		StartExtension	(void);
+	void		StartHint		(void);
+	void		StartThinking	(void);
+	void		StopHint		(void);
 	void		UpdateMetrics	(void);
 
+	static	int	Advise			(void *Data);
+	static	int	Hint			(void *Data);
+	static	int	Think			(void *Data);
+	static	int	ThinkExtension	(void *Data);
+
 	/* Properties */
 	SDL_Surface	*Window;
+	SDL_Thread	*ComputerThread,
+				*HintThread;
+	SDL_mutex	*HintLock;		// Guards HintRanking and HintCount
+	Engine		HintView;		// Snapshot of the player's turn that the hint is worked out on
+	Uint64		HintHash;
+	volatile bool	HintCancelled;	// Set by the main loop to stop the hint thread
+	Engine		ComputerView;	// Snapshot the computer thinks about, so the main loop can carry on
+	Uint64		ComputerHash;
+	WeightTable	ComputerWeights;
+	#ifdef	TRACE_DECISIONS
+	DecisionTrace	ComputerTrace;
+	#endif
 	Surface		ArrowSurfaces[2],
 				Background,
 				CaptionSurface,
@@ -143,15 +151,15 @@ private:
 				MenuSurfaces[MENU_SURFACE_COUNT][2],
 				ModalSurface,
 				OrbSurface,
-				Overlay[5],
+				Overlay[7],
 				ResultTextSurface,
 				ScoreSurfaces[SCORE_CATEGORY_COUNT + 1][SCORE_COLUMN_COUNT],
 				ShadowSurface,
 				TargetSurface,
 				VersionSurface;
-	Player		Players[PLAYER_COUNT];
+	HandView	PlayerHandView;
+	TableauView	TableauViews[PLAYER_COUNT];
 	Options		GameOptions;
-	Deck		*SourceDeck;
 	Stats		PlayerStats;
 	SDL_Rect	Portal;
 	SDL_Color	Black,
@@ -160,30 +168,35 @@ private:
 				White,
 				Yellow;
 	int			DownX, DownY,
-				DragX, DragY,
-				Scores[PLAYER_COUNT],
-				RunningScores[PLAYER_COUNT],
-				ScoreBreakdown[PLAYER_COUNT][SCORE_CATEGORY_COUNT];
-	Uint32		EventCount,
+				DragX, DragY;
+	Uint32		ComputerReadyAt,
+				ComputerThinkTime,
+				EventCount,
 				FrozenAt,
 				MessagedAt;
 	bool		Animating,
 				Dirty,
 				Dragging,
-				Extended, ExtensionDeclined,
 				Frozen,
 				MouseDown,
-				Running;
-	Uint8		Current,				// Index of current player
-				DownIndex,
+				Running,
+				ThoughtExtension;	// Written by the thinking thread
+	Uint8		DownIndex,
 				Modal, LastModal,
 				Scene, LastScene,
 				DeckCount, OldDeckCount,
-				DiscardTop, OldDiscardTop,
-				ExposedCards[CARD_NULL_NULL],
+				OldDiscardTop,
 				Outcome,
-				Difficulty;
-	char		Message[MESSAGE_SIZE];
+				Difficulty,
+				ComputerLevel,
+				HintCount,
+				HintMove,		// Shown on the hand, or MOVE_NONE
+				HintRanking[SEARCH_ACTION_COUNT],	// Written by the hint thread, best move first
+				PendingMove,	// Decided and waiting to be shown
+				ThoughtMove;	// Written by the thinking thread
+	char		ExtensionAdvice[MESSAGE_SIZE],	// What the rollouts expect of each choice, for MODAL_EXTENSION
+				Message[MESSAGE_SIZE],
+				ThoughtAdvice[MESSAGE_SIZE];	// Written by the advising thread
 	TTF_Font	*DrawFont, *GameOverBig, *GameOverSmall;
 
 
@@ -193,11 +206,6 @@ private:
 	enum {	MODAL_GAME_MENU = 0, MODAL_STATS, MODAL_OPTIONS, MODAL_EXTENSION, MODAL_NEW_GAME, MODAL_CLEAR_STATS, MODAL_NONE };
 };
 
-inline	Uint8		Game::UnknownCards	(Uint8 Value)
-{
-	return (EXISTING_CARDS[Value] - KnownCards(Value));
-}
-
 inline	Uint32		Game::Radius		(int X1, int Y1, int X2, int Y2)
 {
 	return sqrt(pow((double) X2 - X1, 2) + pow((double) Y2 - Y1, 2));
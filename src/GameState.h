@@ -0,0 +1,57 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_GAMESTATE_H
+#define	_SDLMILLE_GAMESTATE_H
+
+#include "Player.h"
+
+namespace _SDLMille
+{
+
+enum	{GAMESTATE_EXTENDED = 1, GAMESTATE_EXTENSION_DECLINED = 2};
+
+const	Uint8	GAMESTATE_SIZE_LIMIT = 64;
+
+/*	A whole game position as plain bytes, small enough to fit in one cache line. Copying one
+	is a plain struct copy, so search can clone positions freely; Engine::Pack and
+	Engine::UnPack convert to and from the live game.
+
+	The order of the undrawn cards is not stored, only how many are left. Which cards they are
+	follows from ExposedCards and the two hands, so UnPack deals them back into the deck in a
+	fresh random order. Hand scores aren't stored either; call GetScores after UnPack. */
+
+struct GameState
+{
+	PlayerState	Players[2];
+	Uint8		ExposedCards[(CARD_NULL_NULL + 1) / 2],	// Two counts per byte
+				CardsLeft,
+				Current,
+				DiscardTop,
+				Flags;
+	Sint16		RunningScores[2];
+};
+
+// Fails to compile if GameState outgrows a cache line
+typedef	char	GameStateSizeCheck[(sizeof(GameState) <= GAMESTATE_SIZE_LIMIT) ? 1 : -1];
+
+}
+
+#endif
@@ -40,6 +40,8 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 				Type = CARD_NULL;
 
 		SDL_Surface	*Backdrop = 0;
+		SDL_Rect	Moved[2];	// The card's last place and its new one
+		bool		Partial;
 
 		if (AnimationType < ANIMATION_COUP_FOURRE_BOUNCE)
 		{
@@ -59,7 +61,7 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 			else
 			{
 				if (AnimationType == ANIMATION_COUP_FOURRE_BOUNCE)
-					Tableau::GetTargetCoords(Value, Current, StartX, StartY, false);
+					TableauView::GetTargetCoords(Value, Current, StartX, StartY, false);
 				else if (AnimationType == ANIMATION_SAFETY_SPAWN)
 				{
 					Uint8	SafetyValue = 0;
@@ -69,12 +71,12 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 					else
 						SafetyValue = Value + 5;
 
-					Tableau::GetTargetCoords(SafetyValue, Current, StartX, StartY, false);
+					TableauView::GetTargetCoords(SafetyValue, Current, StartX, StartY, false);
 				}
 				else
 				{
 					if (Current == 0)
-						Hand::GetIndexCoords(Index, StartX, StartY);
+						HandView::GetIndexCoords(Index, StartX, StartY);
 					else
 					{
 						StartX = 140;
@@ -96,15 +98,15 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 				DestY = Dimensions::FirstRowY;
 			}
 			else if ((AnimationType == ANIMATION_PLAY) || (AnimationType == ANIMATION_SAFETY_SPAWN))
-				Tableau::GetTargetCoords(Value, Target, DestX, DestY, CoupFourre, PileCount);
+				TableauView::GetTargetCoords(Value, Target, DestX, DestY, CoupFourre, PileCount);
 			else
-				Hand::GetIndexCoords(Index, DestX, DestY);
+				HandView::GetIndexCoords(Index, DestX, DestY);
 
 
 			if (Current == 0)
-				FloatSurface.SetImage(Card::GetFileFromValue(Value, CoupFourre));
+				FloatSurface.SetSprite(CardAtlas::GetSprite(Value, CoupFourre));
 			else
-				FloatSurface.SetImage("gfx/card_bg.png");
+				FloatSurface.SetSprite(CARD_SPRITE_BACK);
 
 			X = StartX;
 			Y = StartY;
@@ -124,6 +126,10 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 			if (Backdrop != 0)
 				OnRender(Backdrop, true, false);
 
+			Partial = (Backdrop != 0) && !(Window->flags & SDL_DOUBLEBUF);
+			Moved[1].w = std::max(FloatSurface.GetWidth(), (CoupFourre) ? TableauView::ShadowSurfaceCF.GetWidth() : TableauView::ShadowSurface.GetWidth());
+			Moved[1].h = std::max(FloatSurface.GetHeight(), (CoupFourre) ? TableauView::ShadowSurfaceCF.GetHeight() : TableauView::ShadowSurface.GetHeight());
+
 			while ((X != DestX) || (Y != DestY))
 			{
 				//CheckTableau(Backdrop);
@@ -138,7 +144,7 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 				LastLocalBlit = SDL_GetTicks();
 
 				if ((i == TargetFrames / 2) && (Current != 0))
-					FloatSurface.SetImage(Card::GetFileFromValue(Value, CoupFourre));
+					FloatSurface.SetSprite(CardAtlas::GetSprite(Value, CoupFourre));
 
 				if (abs(DestX - X) < IncX)
 					X = DestX;
@@ -160,19 +166,41 @@ void	Game::Animate			(Uint8 Index, Uint8 AnimationType, Uint8 Value)
 						Y += IncY;
 				}
 
-				SDL_BlitSurface(Backdrop, 0, Window, 0);
+				/*	After the first frame, a screen that can be updated in parts only needs
+					the card's last place restored from the backdrop and its new one drawn. */
+				if (Partial && (i > 0))
+				{
+					SDL_Rect	Restore = Moved[1];
+
+					Moved[0] = Moved[1];
+					SDL_BlitSurface(Backdrop, &Moved[0], Window, &Restore);
+				}
+				else
+					SDL_BlitSurface(Backdrop, 0, Window, 0);
 				
 				if (CoupFourre)
-					Tableau::ShadowSurfaceCF.Render(X, Y, Window);
+					TableauView::ShadowSurfaceCF.Render(X, Y, Window);
 				else
-					Tableau::ShadowSurface.Render(X, Y, Window);
+					TableauView::ShadowSurface.Render(X, Y, Window);
 
 				FloatSurface.Render(X, Y, Window);
-				SDL_Flip(Window);
+
+				Moved[1].x = (Sint16) X;
+				Moved[1].y = (Sint16) Y;
+
+				if (!Partial)
+					SDL_Flip(Window);
+				else if (i > 0)
+					Compositor::Push(Window, Moved, 2);
+				else
+					SDL_UpdateRect(Window, 0, 0, 0, 0);
 
 				++i;
 			}
 
+			// The screen no longer matches the last frame the Compositor recorded
+			Compositor::Invalidate();
+
 			Duration = SDL_GetTicks() - StartTicks;
 
 			if (Backdrop != 0)
@@ -209,7 +237,10 @@ bool	Game::OnInit			(void)
 		#endif
 			return false;
 
-		DiscardSurface.SetImage("gfx/null_null.png");
+		// The atlas is built in the display format, so it has to wait for the video mode
+		CardAtlas::Load();
+
+		DiscardSurface.SetSprite(CARD_NULL_NULL);
 
 		UpdateMetrics();
 
@@ -235,6 +266,11 @@ bool	Game::OnInit			(void)
 			Overlay[4].SetImage("gfx/modals/menu_check.png");
 			Overlay[5].SetImage("gfx/modals/menu_x.png");
 
+			if (ExtensionAdvice[0] != '\0')
+				Overlay[6].SetText(ExtensionAdvice, GameOverSmall, &White);
+			else
+				Overlay[6].Clear();
+
 			int BoxHeight = ModalSurface.GetHeight(),
 				BoxWidth = ModalSurface.GetWidth(),
 				BoxTop = (Dimensions::ScreenHeight - BoxHeight) / 2,
@@ -248,6 +284,7 @@ bool	Game::OnInit			(void)
 			Overlay[3].SetCoords(BoxCenterX - (Overlay[3].GetWidth() / 2), BoxTop + ((BoxCenterY - BoxTop - Overlay[3].GetHeight()) / 2));
 			Overlay[4].SetCoords(BoxLeft + (((BoxWidth / 2) - Overlay[4].GetWidth()) / 2), BoxCenterY + (((BoxHeight / 2) - Overlay[4].GetHeight()) / 2));
 			Overlay[5].SetCoords(BoxCenterX + (((BoxWidth / 2) - Overlay[5].GetWidth()) / 2), BoxCenterY + (((BoxHeight / 2) - Overlay[5].GetHeight()) / 2));
+			Overlay[6].SetCoords(BoxCenterX - (Overlay[6].GetWidth() / 2), Overlay[3].GetY() + Overlay[3].GetHeight());
 
 			return true;
 		}
@@ -488,13 +525,13 @@ bool	Game::OnInit			(void)
 				Overlay[2].SetImage("gfx/overlays/line_v.png");
 
 
-			DiscardSurface.SetImage(Card::GetFileFromValue(DiscardTop));
+			DiscardSurface.SetSprite(DiscardTop);
 			TargetSurface.SetImage("gfx/drop_target.png");
 
-			if ((SourceDeck != 0) && (SourceDeck->Empty()))
-				DrawCardSurface.SetImage(Card::GetFileFromValue(CARD_NULL_NULL));
+			if (SourceDeck.Empty())
+				DrawCardSurface.SetSprite(CARD_NULL_NULL);
 			else
-				DrawCardSurface.SetImage("gfx/card_bg.png");
+				DrawCardSurface.SetSprite(CARD_SPRITE_BACK);
 
 			//if (Dimensions::LandscapeMode)
 			//{
@@ -547,8 +584,9 @@ bool	Game::OnInit			(void)
 				MenuSurface.SetImage("gfx/menu.png");
 				MenuSurface.SetCoords(2, 5);
 			}
-			else
-				OrbSurface.SetImage("gfx/orb.png");
+
+			// Marks the hinted discard during play
+			OrbSurface.SetImage("gfx/orb.png");
 
 			return true;
 		}
@@ -693,7 +731,8 @@ void	Game::OnRender			(SDL_Surface *Target, bool Force, bool Flip)
 	static	Uint32	LastRender	= 0;
 			Uint32	TickCount	= SDL_GetTicks();
 
-	bool	RefreshedSomething =	false, // We only flip the display if something changed
+	bool	Partial =				false, // Whether only the changes go to the screen
+			RefreshedSomething =	false, // We only flip the display if something changed
 			SceneChanged =			false; // Control variable. Do we need to call OnInit()?
 
 	#ifdef DEBUG
@@ -707,7 +746,7 @@ void	Game::OnRender			(SDL_Surface *Target, bool Force, bool Flip)
 		LastReset = TickCount;
 		DebugSurface.SetInteger(FrameCount * 3, GameOverBig, true, &Black, &White);
 		FrameCount = 0;
-		RefreshedSomething = true;
+		Force = true;
 	}
 	#endif
 
@@ -719,6 +758,7 @@ void	Game::OnRender			(SDL_Surface *Target, bool Force, bool Flip)
 		}
 	#endif
 
+	// Catches anything that changed without setting Dirty; redraws nothing that hasn't
 	if (LastRender < (TickCount - 1000))
 	{
 		Dirty = true;
@@ -760,7 +800,11 @@ void	Game::OnRender			(SDL_Surface *Target, bool Force, bool Flip)
 			OnInit(); //Refresh our surfaces
 
 		//Force = true;
-		RefreshedSomething = true;
+
+		/*	On a screen that can be updated in parts, the Compositor records the frame
+			and puts only what changed since the last one on the screen itself. */
+		Partial = Flip && Compositor::Begin(Target);
+		RefreshedSomething = !Partial;
 	
 		// Render the appropriate surfaces
 		Background.Fill(0, 0, Target);
@@ -769,11 +813,14 @@ void	Game::OnRender			(SDL_Surface *Target, bool Force, bool Flip)
 
 		if (Modal < MODAL_NONE)
 			OnRenderModal(Target);
-	}
 
-	#ifdef DEBUG
-	DebugSurface.Render(0, 0, Target);
-	#endif
+		#ifdef DEBUG
+		DebugSurface.Render(0, 0, Target);
+		#endif
+
+		if (Partial)
+			Compositor::End();
+	}
 
 	if (RefreshedSomething && Flip)
 		SDL_Flip(Target);
@@ -793,6 +840,7 @@ void	Game::OnRenderModal		(SDL_Surface *Target)
 			Overlay[3].Render(Target);
 			Overlay[4].Render(Target);
 			Overlay[5].Render(Target);
+			Overlay[6].Render(Target);
 		}
 		else if (Modal <= MODAL_OPTIONS)
 		{
@@ -884,7 +932,7 @@ void	Game::OnRenderScene		(SDL_Surface *Target)
 		}
 
 		for (int i = (PLAYER_COUNT - 1); i >= 0; --i)
-			Players[i].OnRender(Target, i, true);
+			TableauViews[i].OnRender(Target, Players[i].GetTableau(), i, true);
 
 			
 		Overlay[1].RepeatX(0, Dimensions::TableauHeight, Target);
@@ -896,9 +944,13 @@ void	Game::OnRenderScene		(SDL_Surface *Target)
 
 		Overlay[0].Fill(FillX, FillY, Target);
 
-		Players[0].OnRenderHand(Target, true);
+		PlayerHandView.SetHint((HintMove < MOVE_COUNT) ? HintMove % DISCARD_OFFSET : HAND_SIZE);
+		PlayerHandView.OnRender(Target, Players[0].GetHand(), true);
 
 		DiscardSurface.Render(Target);
+		if ((HintMove >= DISCARD_OFFSET) && (HintMove < MOVE_COUNT) && OrbSurface)
+			OrbSurface.Render(DiscardSurface.GetX() + ((DiscardSurface.GetWidth() - OrbSurface.GetWidth()) >> 1),
+							  DiscardSurface.GetY() + ((DiscardSurface.GetHeight() - OrbSurface.GetHeight()) >> 1), Target);
 		DrawCardSurface.Render(Target);
 		DrawTextSurface.Render(Target);
 			
@@ -1011,9 +1063,9 @@ void	Game::OnRenderScene		(SDL_Surface *Target)
 	if (Dragging && !Animating)
 	{
 		if (Players[Current].GetValue(DownIndex) == Card::GetMatchingSafety(Players[Current].GetQualifiedCoupFourre()))
-			Tableau::ShadowSurfaceCF.Render(DragX - 20, DragY - 67, Target, SCALE_NONE);
+			TableauView::ShadowSurfaceCF.Render(DragX - 20, DragY - 67, Target, SCALE_NONE);
 		else
-			Tableau::ShadowSurface.Render(DragX - 20, DragY - 67, Target, SCALE_NONE);
+			TableauView::ShadowSurface.Render(DragX - 20, DragY - 67, Target, SCALE_NONE);
 
 		FloatSurface.Render(DragX - 20, DragY - 67, Target, SCALE_NONE);
 	}
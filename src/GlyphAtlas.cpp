@@ -0,0 +1,191 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "GlyphAtlas.h"
+#include <algorithm>
+
+namespace _SDLMille
+{
+
+std::vector<GlyphAtlas::Sheet>	GlyphAtlas::Sheets;
+
+/* Public methods */
+
+void			GlyphAtlas::Forget		(TTF_Font *Font)
+{
+	std::vector<Sheet>::iterator	i = Sheets.begin();
+
+	while (i != Sheets.end())
+	{
+		if (i->Font == Font)
+		{
+			if (i->Image != 0)
+				SDL_FreeSurface(i->Image);
+
+			i = Sheets.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+SDL_Surface *	GlyphAtlas::Render		(const char *Text, TTF_Font *Font, const SDL_Color &Foreground, const SDL_Color *Background)
+{
+	Sheet		*Found = 0;
+	SDL_Surface	*Composed = 0;
+	int			Width = 0;
+
+	if ((Text == 0) || (Text[0] == 0) || (Font == 0))
+		return 0;
+
+	for (const char *c = Text; *c != 0; ++c)
+	{
+		if (((Uint8) *c < GLYPH_FIRST) || ((Uint8) *c > GLYPH_LAST))
+			return 0;
+	}
+
+	Found = Find(Font, Foreground, Background);
+
+	if ((Found == 0) || (Found->Image == 0))
+		return 0;
+
+	for (const char *c = Text; *c != 0; ++c)
+		Width += Found->Cells[(Uint8) *c - GLYPH_FIRST].w;
+
+	Composed = SDL_CreateRGBSurface(SDL_SWSURFACE, Width, Found->Image->h, 32, Found->Image->format->Rmask,
+		Found->Image->format->Gmask, Found->Image->format->Bmask, Found->Image->format->Amask);
+
+	if (Composed == 0)
+		return 0;
+
+	Width = 0;
+
+	for (const char *c = Text; *c != 0; ++c)
+	{
+		SDL_Rect	Cell = Found->Cells[(Uint8) *c - GLYPH_FIRST],
+					Destination;
+
+		Destination.x = Width;
+		Destination.y = 0;
+
+		SDL_BlitSurface(Found->Image, &Cell, Composed, &Destination);
+		Width += Cell.w;
+	}
+
+	return Composed;
+}
+
+/* Private methods */
+
+bool			GlyphAtlas::Build		(Sheet &Target)
+{
+	SDL_Surface	*Glyphs[GLYPH_COUNT];
+	char		Text[2] = {0, 0};
+	int			Height = 0,
+				Width = 0;
+	bool		Success = true;
+
+	Target.Image = 0;
+
+	for (Uint8 i = 0; i < GLYPH_COUNT; ++i)
+	{
+		Text[0] = GLYPH_FIRST + i;
+
+		if (Target.Shaded)
+			Glyphs[i] = TTF_RenderText_Shaded(Target.Font, Text, Target.Foreground, Target.Background);
+		else
+			Glyphs[i] = TTF_RenderText_Blended(Target.Font, Text, Target.Foreground);
+
+		if (Glyphs[i] == 0)
+		{
+			Success = false;
+			continue;
+		}
+
+		Target.Cells[i].x = Width;
+		Target.Cells[i].y = 0;
+		Target.Cells[i].w = Glyphs[i]->w;
+		Target.Cells[i].h = Glyphs[i]->h;
+
+		Width += Glyphs[i]->w;
+		Height = std::max(Height, Glyphs[i]->h);
+	}
+
+	// Blended text keeps its coverage in the alpha channel, shaded text is opaque
+	if (Success)
+		Target.Image = SDL_CreateRGBSurface(SDL_SWSURFACE, Width, Height, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, Target.Shaded ? 0 : 0xFF000000);
+
+	for (Uint8 i = 0; i < GLYPH_COUNT; ++i)
+	{
+		if (Glyphs[i] == 0)
+			continue;
+
+		if (Target.Image != 0)
+		{
+			SDL_Rect	Cell = Target.Cells[i];
+
+			// Without SDL_SRCALPHA the blit copies the alpha channel rather than blending with it
+			SDL_SetAlpha(Glyphs[i], 0, SDL_ALPHA_OPAQUE);
+			SDL_BlitSurface(Glyphs[i], 0, Target.Image, &Cell);
+		}
+
+		SDL_FreeSurface(Glyphs[i]);
+	}
+
+	if (Target.Image == 0)
+		return false;
+
+	// Strings are put together by copying cells, alpha and all
+	SDL_SetAlpha(Target.Image, 0, SDL_ALPHA_OPAQUE);
+
+	return true;
+}
+
+GlyphAtlas::Sheet *	GlyphAtlas::Find		(TTF_Font *Font, const SDL_Color &Foreground, const SDL_Color *Background)
+{
+	Sheet	Built;
+	bool	Shaded = (Background != 0);
+
+	for (std::vector<Sheet>::iterator i = Sheets.begin(); i != Sheets.end(); ++i)
+	{
+		if ((i->Font != Font) || (i->Shaded != Shaded))
+			continue;
+
+		if ((i->Foreground.r != Foreground.r) || (i->Foreground.g != Foreground.g) || (i->Foreground.b != Foreground.b))
+			continue;
+
+		if (Shaded && ((i->Background.r != Background->r) || (i->Background.g != Background->g) || (i->Background.b != Background->b)))
+			continue;
+
+		return &(*i);
+	}
+
+	Built.Font = Font;
+	Built.Foreground = Foreground;
+	Built.Background = Shaded ? *Background : Foreground;
+	Built.Shaded = Shaded;
+
+	Build(Built);
+	Sheets.push_back(Built);
+
+	return &Sheets.back();
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_GLYPH_ATLAS_H
+#define	_SDLMILLE_GLYPH_ATLAS_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	Uint8	GLYPH_FIRST = 32,	// Printable ASCII, space to tilde
+				GLYPH_LAST = 126,
+				GLYPH_COUNT = GLYPH_LAST - GLYPH_FIRST + 1;
+
+/*	Text composed from glyphs rasterized once. The first time a font is used with a colour,
+	every printable character is rendered on its own into one sheet. After that, a string is
+	built by copying its characters' cells side by side, so a score or a mileage counter
+	changing no longer goes through FreeType.
+
+	Each single character render is as wide as the character's advance, which is exactly how
+	far the whole string render moves on in a monospaced font like the game's. Strings with
+	anything outside printable ASCII, or a sheet that couldn't be built, return 0 and the
+	caller renders with SDL_ttf as before. Sheets refer to their font, so Forget has to be
+	called before the font is closed. */
+
+class GlyphAtlas
+{
+public:
+	static	void			Forget		(TTF_Font *Font);
+	static	SDL_Surface *	Render		(const char *Text, TTF_Font *Font, const SDL_Color &Foreground, const SDL_Color *Background);
+private:
+	struct Sheet
+	{
+		TTF_Font	*Font;
+		SDL_Color	Foreground,
+					Background;
+		bool		Shaded;
+		SDL_Surface	*Image;		// 0 if it couldn't be built, so it isn't tried again
+		SDL_Rect	Cells[GLYPH_COUNT];
+	};
+
+	static	bool			Build		(Sheet &Target);
+	static	Sheet *			Find		(TTF_Font *Font, const SDL_Color &Foreground, const SDL_Color *Background);
+
+	static	std::vector<Sheet>	Sheets;
+};
+
+}
+
+#endif
@@ -25,6 +25,7 @@ namespace _SDLMille
 		Hand::Hand		(void)
 {
 	Dirty = false;
+	Hash = 0;
 
 	for (int i = 0; i < HAND_SIZE; ++i)
 	{
@@ -58,6 +59,11 @@ bool	Hand::Discard	(Uint8 Index)
 		Detached[Index] = false;
 		Popped[Index] = false;
 
+		if (ThisHand[Index].GetValue() < CARD_NULL_NULL)
+			Hash -= GetZobristKey(ZOBRIST_HAND + ThisHand[Index].GetValue());
+
+		Held.Remove(ThisHand[Index].GetValue());
+
 		return ThisHand[Index].Discard();
 	}
 
@@ -68,8 +74,18 @@ bool	Hand::Draw		(Deck * Source, Uint8 Index)
 {
 	if (Index < HAND_SIZE)
 	{
+		Uint8	OldValue = ThisHand[Index].GetValue();
+
 		if (ThisHand[Index].Draw(Source))
 		{
+			if (OldValue < CARD_NULL_NULL)
+				Hash -= GetZobristKey(ZOBRIST_HAND + OldValue);
+			if (ThisHand[Index].GetValue() < CARD_NULL_NULL)
+				Hash += GetZobristKey(ZOBRIST_HAND + ThisHand[Index].GetValue());
+
+			Held.Remove(OldValue);
+			Held.Add(ThisHand[Index].GetValue());
+
 			Dirty = true;
 			return true;
 		}
@@ -78,66 +94,6 @@ bool	Hand::Draw		(Deck * Source, Uint8 Index)
 	return false;
 }
 
-Uint8	Hand::GetIndex			(int X, int Y)
-{
-	Uint8	Invalid = 0xFF;
-
-	int ColCount = Dimensions::GamePlayCardsPerRow,
-		RowCount = ceil((double) HAND_SIZE / Dimensions::GamePlayCardsPerRow),
-		MinX = Dimensions::GamePlayHandLeftX,
-		MaxX = MinX + (ColCount * Dimensions::GamePlayCardWidth) + ((ColCount - 1) * Dimensions::GamePlayCardSpacingX),
-		MinY = Dimensions::FirstRowY,
-		MaxY = MinY + (RowCount * Dimensions::GamePlayCardHeight) + ((RowCount - 1) * Dimensions::GamePlayCardSpacingY),
-		XIncrement = Dimensions::GamePlayCardWidth + Dimensions::GamePlayCardSpacingX,
-		YIncrement = Dimensions::GamePlayCardHeight + Dimensions::GamePlayCardSpacingY;
-
-	if ((Y >= MinY) && (Y <= MaxY))
-	{
-		Uint8	RowIndex = 0,
-				Index = 0;
-
-		//if (Y >= Dimensions::SecondRowY)	// Clicked the bottom row. Add 4 to the index
-		//	Add = 4;
-		//else if (Y >= (Dimensions::FirstRowY + 57))	//Clicked in the dead zone
-		//	return Invalid;
-
-		if ((Y - MinY) % YIncrement < Dimensions::GamePlayCardHeight)
-			RowIndex = (Y - MinY) / YIncrement;
-		else
-			return Invalid;
-
-		if ((X >= MinX) && (X <= MaxX))	//Clicked within hand
-		{
-			if (((X - MinX) % XIncrement) < Dimensions::GamePlayCardWidth)
-			{
-				int Index = (((X - MinX) / XIncrement) + (RowIndex * Dimensions::GamePlayCardsPerRow));
-
-				if (Dimensions::GamePlayMultiRowTray)
-					--Index;
-
-				if (Index < HAND_SIZE)
-					return Index;
-			}
-		}
-	}
-
-	return Invalid;
-}
-
-void	Hand::GetIndexCoords	(Uint8 Index, int &X, int &Y)
-{
-	if (Index < 3)
-	{
-		X = 81 + (65 * (Index + 1));
-		Y = Dimensions::FirstRowY;
-	}
-	else
-	{
-		X = 81 + (65 * (Index - 3));
-		Y = Dimensions::SecondRowY;
-	}
-}
-
 Uint8	Hand::GetType	(Uint8 Index)						const
 {
 	if (Index < HAND_SIZE)
@@ -162,90 +118,10 @@ bool	Hand::IsPopped	(Uint8 Index)						const
 	return false;
 }
 
-void	Hand::OnInit	(void)
+void	Hand::Pack		(Uint8 *Values)						const
 {
-	OrbSurface.SetImage("gfx/orb.png");
-	CancelSurface.SetImage("gfx/cancel.png");
-	Overlay.SetImage("gfx/overlays/game_play_2.png");
-
 	for (int i = 0; i < HAND_SIZE; ++i)
-	{
-		if (Detached[i])
-			CardSurfaces[i].SetImage(Card::GetFileFromValue(CARD_NULL_NULL));
-		else
-			CardSurfaces[i].SetImage(Card::GetFileFromValue(ThisHand[i].GetValue()));
-	}
-}
-
-bool	Hand::OnRender	(SDL_Surface * Target, bool Force)
-{
-	bool	WasDirty = Dirty;
-	
-	if (Target != 0)
-	{
-		if (Dirty || Force)
-		{
-			if (Dirty)
-			{
-				OnInit();
-				Dirty = false;
-			}
-
-			//Overlay.Render(0, Dimensions::EffectiveTableauHeight * 2, Target, SCALE_NONE);
-
-			int	XIncrement = Dimensions::GamePlayCardWidth + Dimensions::GamePlayCardSpacingX,
-				YIncrement = Dimensions::GamePlayCardHeight + Dimensions::GamePlayCardSpacingY;
-
-			for (int i = 0; i < HAND_SIZE; ++i)
-			{
-				/*	The next line is a fancy (and more efficient) way of multiplying i times 65 and then
-					adding 81. 65 is the horizontal distance between two cards, and 81 is the left edge
-					of our render. */
-
-				int	IndexVal = (Dimensions::GamePlayMultiRowTray) ? i + 1 : i;
-
-				int RowNum = IndexVal / Dimensions::GamePlayCardsPerRow,
-					ColNum = IndexVal % Dimensions::GamePlayCardsPerRow;
-
-				int X = Dimensions::GamePlayHandLeftX + (ColNum * XIncrement),
-					Y = Dimensions::FirstRowY + (RowNum * YIncrement);
-
-				//int	X = Dimensions::GamePlayHandLeftX + (i * (Dimensions::GamePlayCardWidth + Dimensions::GamePlayCardSpacingX)),
-				//	Y =	Dimensions::FirstRowY;
-
-				//if ((i >= 4) && Dimensions::GamePlayMultiRowTray)
-				//{
-				//	// The remaining cards get a left-shift four spaces (to account for the four spaces
-				//	// above). Y is set for the second row.
-				//	X -= ((Dimensions::GamePlayCardWidth + Dimensions::GamePlayCardSpacingX) << 2);
-				//	Y = Dimensions::SecondRowY;
-				//}
-				//else
-				//{
-				//	//TODO: Update comments
-				//	// The first three cards get a right-shift one space. Y is set for the top row.
-				//	//X += 65;
-				//	Y = Dimensions::FirstRowY;
-				//}
-
-				//if (i == 0)
-				//	CancelSurface.Render(X, Y, Target);
-				//else
-				//{
-					//int	Index = i - 1;
-				if (CardSurfaces[i])
-				{
-					CardSurfaces[i].Render(X, Y, Target);	//Draw the cards
-
-					if (Popped[i] && OrbSurface && !Detached[i])	//If this card is popped, render the orb over it
-						OrbSurface.Render(X, Y + (Dimensions::GamePlayCardHeight >> 1) - (OrbSurface.GetHeight() >> 1), Target);
-				}
-				//}
-			}
-		}
-	}
-
-	return WasDirty;
+		Values[i] = ThisHand[i].GetValue();
 }
 
 void	Hand::Pop		(Uint8 Index)
@@ -281,6 +157,8 @@ void	Hand::Reset		(void)
 		Popped[i] = false;
 	}
 
+	Held.Clear();
+	Hash = 0;
 	Dirty = true;
 }
 
@@ -292,6 +170,8 @@ bool	Hand::Restore	(FILE *SaveFile)
 	{
 		for (int i = 0; i < HAND_SIZE; ++i)
 			Success &= ThisHand[i].Restore(SaveFile);
+
+		Rehash();
 	}
 	else
 		Success = false;
@@ -314,6 +194,19 @@ bool	Hand::Save		(FILE *SaveFile)
 	return false;
 }
 
+void	Hand::UnPack	(const Uint8 *Values)
+{
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		ThisHand[i].Copy(Card(Values[i]));
+		Detached[i] = false;
+		Popped[i] = false;
+	}
+
+	Rehash();
+	Dirty = true;
+}
+
 void	Hand::UnPop		(Uint8 Index)
 {
 	if (Index < HAND_SIZE)
@@ -324,4 +217,21 @@ void	Hand::UnPop		(Uint8 Index)
 	}
 }
 
+/* Private methods */
+
+void	Hand::Rehash	(void)
+{
+	// Recounts too, for when the whole hand changes at once
+	Held.Clear();
+	Hash = 0;
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (ThisHand[i].GetValue() < CARD_NULL_NULL)
+			Hash += GetZobristKey(ZOBRIST_HAND + ThisHand[i].GetValue());
+
+		Held.Add(ThisHand[i].GetValue());
+	}
+}
+
 }
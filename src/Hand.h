@@ -20,7 +20,9 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef _SDLMILLE_HAND_H
 #define _SDLMILLE_HAND_H
 
+#include "CardCounter.h"
 #include "Card.h"
+#include "Zobrist.h"
 
 namespace	_SDLMille
 {
@@ -34,31 +36,64 @@ public:
 				~Hand		(void)							{}
 	void		Detach		(Uint8 Index);
 	bool		Discard		(Uint8 Index);
+	void		ClearDirty	(void);
 	bool		Draw		(Deck * Source, Uint8 Index);
-static	Uint8		GetIndex		(int X, int Y);
-static	void		GetIndexCoords	(Uint8 Index, int &X, int &Y);
+	Uint8		GetCount	(Uint8 Value)								const;
+	Uint64		GetHash		(void)										const;
+	Uint8		GetTotal	(void)										const;
 	Uint8		GetType		(Uint8 Index)								const;
 	Uint8		GetValue	(Uint8 Index)								const;
+	bool		IsDetached	(Uint8 Index)								const;
 	bool		IsDirty		(void)										const;
 	bool		IsPopped	(Uint8 Index)								const;
-	void		OnInit		(void);
-	bool		OnRender	(SDL_Surface * Target, bool Force = false);
+	void		Pack		(Uint8 *Values)								const;
 	void		Pop			(Uint8 Index);
 	void		Reset		(void);
 	bool		Restore		(FILE *SaveFile);
 	bool		Save		(FILE *SaveFile);
+	void		UnPack		(const Uint8 *Values);
 	void		UnPop		(Uint8 Index);
 private:
+	/* Methods */
+	void		Rehash		(void);
+
+	/* Properties */
 	Card		ThisHand[HAND_SIZE];
 	bool		Detached[HAND_SIZE],
 				Dirty,
 				Popped[HAND_SIZE];
-	Surface		CancelSurface,
-				CardSurfaces[HAND_SIZE],				
-				OrbSurface,
-				Overlay;
+	CardCounter	Held;
+	Uint64		Hash;	// Sum of the ZOBRIST_HAND keys of the cards held
 };
 
+inline	void	Hand::ClearDirty	(void)
+{
+	Dirty = false;
+}
+
+inline	Uint8	Hand::GetCount	(Uint8 Value)	const
+{
+	return Held.Get(Value);
+}
+
+inline	Uint64	Hand::GetHash	(void)	const
+{
+	return Hash;
+}
+
+inline	Uint8	Hand::GetTotal	(void)	const
+{
+	return Held.GetTotal();
+}
+
+inline	bool	Hand::IsDetached	(Uint8 Index)	const
+{
+	if (Index < HAND_SIZE)
+		return Detached[Index];
+
+	return false;
+}
+
 inline	bool	Hand::IsDirty	(void)	const
 {
 	return Dirty;
@@ -0,0 +1,58 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_HANDVIEW_H
+#define _SDLMILLE_HANDVIEW_H
+
+#include "Hand.h"
+#include "Surface.h"
+
+namespace	_SDLMille
+{
+
+/*	Renders the human player's hand. The hand itself lives in the rules engine and knows
+	nothing about SDL; this class owns the surfaces and the screen geometry. */
+
+class HandView
+{
+public:
+				HandView		(void)							{HintIndex = HAND_SIZE;}
+				~HandView		(void)							{}
+static	Uint8		GetIndex		(int X, int Y);
+static	void		GetIndexCoords	(Uint8 Index, int &X, int &Y);
+	void		OnInit			(const Hand &Model);
+	bool		OnRender		(SDL_Surface * Target, Hand &Model, bool Force = false);
+	void		SetHint			(Uint8 Index);
+private:
+	Surface		CancelSurface,
+				CardSurfaces[HAND_SIZE],
+				OrbSurface,
+				Overlay;
+	Uint8		HintIndex;		// Card marked as the suggested move, or HAND_SIZE for none
+};
+
+inline	void	HandView::SetHint		(Uint8 Index)
+{
+	HintIndex = Index;
+}
+
+}
+
+#endif
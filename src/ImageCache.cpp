@@ -0,0 +1,98 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "ImageCache.h"
+#include "Surface.h"
+#include <string.h>
+
+namespace _SDLMille
+{
+
+std::vector<ImageCache::Entry>	ImageCache::Entries;
+Uint32	ImageCache::Hits = 0,
+		ImageCache::Misses = 0;
+
+/* Public methods */
+
+SDL_Surface *	ImageCache::Acquire		(const char *File)
+{
+	Entry	Loaded;
+
+	if (File == 0)
+		return 0;
+
+	for (std::vector<Entry>::iterator i = Entries.begin(); i != Entries.end(); ++i)
+	{
+		if (strcmp(i->File, File) == 0)
+		{
+			++Hits;
+			++i->References;
+			return i->Image;
+		}
+	}
+
+	++Misses;
+
+	// A file that failed to load isn't remembered, so it is tried again next time
+	Loaded.Image = Surface::Load(File);
+
+	if (Loaded.Image == 0)
+		return 0;
+
+	Loaded.File = new char[strlen(File) + 1];
+	strcpy(Loaded.File, File);
+	Loaded.References = 1;
+
+	Entries.push_back(Loaded);
+
+	return Loaded.Image;
+}
+
+void			ImageCache::Purge		(void)
+{
+	std::vector<Entry>::iterator	i = Entries.begin();
+
+	while (i != Entries.end())
+	{
+		if (i->References <= 0)
+		{
+			SDL_FreeSurface(i->Image);
+			delete [] i->File;
+			i = Entries.erase(i);
+		}
+		else
+			++i;
+	}
+}
+
+void			ImageCache::Release		(SDL_Surface *Image)
+{
+	// Surfaces that didn't come from here, like the card atlas, are left alone
+	for (std::vector<Entry>::iterator i = Entries.begin(); i != Entries.end(); ++i)
+	{
+		if (i->Image == Image)
+		{
+			--i->References;
+			return;
+		}
+	}
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_IMAGE_CACHE_H
+#define	_SDLMILLE_IMAGE_CACHE_H
+
+#include <SDL.h>
+#include <vector>
+
+namespace _SDLMille
+{
+
+/*	Every image loaded by path, decoded and converted to the display format once per process.
+	Acquire hands out the shared surface and counts a reference, and Release gives one back.
+	An image nobody holds stays loaded, so a surface switching back to it, or a view rebuilt
+	by OnInit, costs a lookup instead of a decode. Purge frees those idle images.
+
+	A game uses a few dozen images, so the entries are a list searched by name rather than a
+	hash. Hits and misses are counted for tuning. */
+
+class ImageCache
+{
+public:
+	static	SDL_Surface *	Acquire		(const char *File);
+	static	Uint32			GetHits		(void);
+	static	Uint32			GetMisses	(void);
+	static	void			Purge		(void);
+	static	void			Release		(SDL_Surface *Image);
+private:
+	struct Entry
+	{
+		char		*File;
+		SDL_Surface	*Image;
+		int			References;
+	};
+
+	static	std::vector<Entry>	Entries;
+	static	Uint32				Hits,
+								Misses;
+};
+
+inline	Uint32	ImageCache::GetHits		(void)
+{
+	return Hits;
+}
+
+inline	Uint32	ImageCache::GetMisses	(void)
+{
+	return Misses;
+}
+
+}
+
+#endif
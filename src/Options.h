@@ -27,10 +27,10 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 namespace	_SDLMille
 {
 
-enum	{OPTION_CARD_CAPTIONS = 0, OPTION_FAST_GAME, OPTION_ANIMATIONS, OPTION_HARD_DIFFICULTY, OPTION_VERTICAL_TRAY, OPTION_COUNT};
+enum	{OPTION_CARD_CAPTIONS = 0, OPTION_FAST_GAME, OPTION_ANIMATIONS, OPTION_HARD_DIFFICULTY, OPTION_VERTICAL_TRAY, OPTION_HINTS, OPTION_COUNT};
 
 const	Uint16	OPTION_VERSION = 4;
-const	char	OPTION_NAMES[OPTION_COUNT][16] = {"Card captions", "Fast game", "Animations", "Hard Difficulty", "Vertical Tray"};
+const	char	OPTION_NAMES[OPTION_COUNT][16] = {"Card captions", "Fast game", "Animations", "Hard Difficulty", "Vertical Tray", "Hints"};
 
 class	Options
 {
@@ -25,20 +25,11 @@ namespace _SDLMille
 		Player::Player			(void)
 {
 	QualifiedCoupFourre = 0xFF;	//Player does not qualify for a Coup Fourre
-	SourceDeck = 0;
 }
 
 Uint8	Player::CardsInHand		(void)					const
 {
-	Uint8 ReturnValue = 0;
-
-	for (int i = 0; i < HAND_SIZE; ++i)
-	{
-		if (PlayerHand.GetValue(i) < CARD_NULL_NULL)
-			++ReturnValue;
-	}
-
-	return ReturnValue;
+	return PlayerHand.GetTotal();
 }
 
 bool	Player::Discard			(Uint8 Index)
@@ -52,48 +43,41 @@ bool	Player::Discard			(Uint8 Index)
 	return false;
 }
 
-void	Player::Draw			(void)
+void	Player::Draw			(Deck * Source)
 {
-	if (SourceDeck != 0)
+	if (Source != 0)
 	{
 		for (int i = 0; i < HAND_SIZE; ++i)
 		{
 			// If we find an empty slot, and we've got a draw pile to draw from,
 			// draw one card and then return
-			if (GetValue(i) == CARD_NULL_NULL && !SourceDeck->Empty())
+			if (GetValue(i) == CARD_NULL_NULL && !Source->Empty())
 			{
-				PlayerHand.Draw(SourceDeck, i);
+				PlayerHand.Draw(Source, i);
 				return;
 			}
 		}
 	}
 }
 
-bool	Player::Draw			(Uint8 Index)
+bool	Player::Draw			(Deck * Source, Uint8 Index)
 {
-	if (SourceDeck != 0)
-		return PlayerHand.Draw(SourceDeck, Index);
+	if (Source != 0)
+		return PlayerHand.Draw(Source, Index);
 
 	return false;
 }
 
 bool	Player::IsOutOfCards	(void)												const
 {
-	// If we find a populated card slot, immediately return false.
-	for (int i = 0; i < HAND_SIZE; ++i)
-	{
-		if (GetType(i) != CARD_NULL)
-			return false;
-	}
-
-	return true;	//We didn't find a populated slot
+	return (PlayerHand.GetTotal() == 0);
 }
 
 int		Player::MileageInHand	(void)												const
 {
 	int ReturnValue = 0;
-	for (int i = 0; i < HAND_SIZE; ++i)
-		ReturnValue += Card::GetMileValue(PlayerHand.GetValue(i));
+	for (int i = CARD_MILEAGE_25; i <= CARD_MILEAGE_200; ++i)
+		ReturnValue += PlayerHand.GetCount(i) * Card::GetMileValue(i);
 
 	return ReturnValue;
 }
@@ -126,28 +110,13 @@ Uint8	Player::OnPlay			(Uint8 Index)
 	return ReturnValue;
 }
 
-bool	Player::OnRender		(SDL_Surface * Target, Uint8 PlayerIndex, bool Force)
+void	Player::Pack			(PlayerState &State)								const
 {
-	/*	DidSomething is a control variable that tells our calling function whether or not
-		we actually rendered anything. If nobody in the call chain "does something" then
-		the top-level function will not flip the screen. */
-	bool DidSomething =		false;
-
-	DidSomething |= MyTableau.OnRender(Target, PlayerIndex, Force);
-
-	//if (PlayerIndex == 0)		//Render the human player's hand
-	//	DidSomething = PlayerHand.OnRender(Target, Force);
-	
-	//TODO: Remove PlayerIndex parameter
-
-	return DidSomething;
+	MyTableau.Pack(State.Table);
+	PlayerHand.Pack(State.Cards);
+	State.QualifiedCoupFourre = QualifiedCoupFourre;
 }
 
-bool	Player::OnRenderHand	(SDL_Surface *Target, bool Force)
-{
-	return PlayerHand.OnRender(Target, Force);	//TODO: Inline
-}	
-
 bool	Player::ReceiveHazard	(Uint8 Value)
 {
 	// Sanity check: we don't have immunity to the hazard, and it is, in fact, a hazard
@@ -167,7 +136,6 @@ bool	Player::ReceiveHazard	(Uint8 Value)
 
 void	Player::Reset			(void)
 {
-	SourceDeck = 0;
 	QualifiedCoupFourre = 0xFF;
 
 	PlayerHand.Reset();
@@ -202,10 +170,11 @@ bool	Player::Save			(FILE * SaveFile)
 	return false;
 }
 
-void	Player::SetSource		(Deck * ArgSource)
+void	Player::UnPack			(const PlayerState &State)
 {
-	if ((SourceDeck == 0) && (ArgSource != 0))	//SourceDeck isn't set, and ArgSource is set
-		SourceDeck = ArgSource;
+	MyTableau.UnPack(State.Table);
+	PlayerHand.UnPack(State.Cards);
+	QualifiedCoupFourre = State.QualifiedCoupFourre;
 }
 
 }
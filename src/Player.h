@@ -28,6 +28,13 @@ namespace _SDLMille
 
 const int	PLAYER_GIVEN_NO_ARGUMENT =	3000;
 
+struct PlayerState
+{
+	TableauState	Table;
+	Uint8			Cards[HAND_SIZE],
+					QualifiedCoupFourre;
+};
+
 class Player
 {
 public:
@@ -36,10 +43,14 @@ public:
 	Uint8		CardsInHand			(void)					const;
 	bool		Discard			(Uint8 Index);
 	void		Detach			(Uint8 Index);
-	void		Draw			(void);
-	bool		Draw			(Uint8 Index);
+	void		Draw			(Deck * Source);
+	bool		Draw			(Deck * Source, Uint8 Index);
+	Uint8		GetCount		(Uint8 Value)				const;
+	Hand &		GetHand			(void);
+	Uint64		GetHash			(void)						const;
 	int			GetMileage		(void)						const;
 	Uint8		GetPileCount	(Uint8 Value)				const;
+	Tableau &	GetTableau		(void);
 	Uint8		GetTopCard		(bool SpeedPile = false)	const;
 	Uint8		GetType			(Uint8 Index)				const;
 	Uint8		GetQualifiedCoupFourre	(void)				const;
@@ -53,21 +64,19 @@ public:
 	bool		IsRolling		(void)						const;
 	int			MileageInHand	(void)						const;
 	Uint8		OnPlay			(Uint8 Index);
-	bool		OnRender		(SDL_Surface * Target, Uint8 PlayerIndex, bool Force = false);
-	bool		OnRenderHand	(SDL_Surface *Target, bool Force = false);
+	void		Pack			(PlayerState &State)		const;
 	void		Pop				(Uint8 Index);
 	bool		ReceiveHazard	(Uint8 Value);
 	void		Reset			(void);
 	bool		Restore			(FILE *SaveFile);
 	bool		Save			(FILE *SaveFile);
-	void		SetSource		(Deck * ArgSource);
+	void		UnPack			(const PlayerState &State);
 	void		UnPop			(Uint8 Index);
 	void		UpdateTopCard	(bool IncludeRollCard, bool IncludeEndLimit);
 private:
 	Tableau		MyTableau;
 	Hand		PlayerHand;
 	Uint8		QualifiedCoupFourre;
-	Deck *		SourceDeck;
 };
 
 //inline	bool	Player::AnimationRunning	(void)			const
@@ -80,11 +89,31 @@ inline	void	Player::Detach			(Uint8 Index)
 	PlayerHand.Detach(Index);
 }
 
+inline	Uint8	Player::GetCount		(Uint8 Value)	const
+{
+	return PlayerHand.GetCount(Value);
+}
+
+inline	Hand &	Player::GetHand			(void)
+{
+	return PlayerHand;
+}
+
+inline	Uint64	Player::GetHash			(void)	const
+{
+	return PlayerHand.GetHash() ^ MyTableau.GetHash() ^ GetZobristCardKey(ZOBRIST_QUALIFIED, QualifiedCoupFourre);
+}
+
 inline	Uint8	Player::GetPileCount	(Uint8 Value)		const
 {
 	return MyTableau.GetPileCount(Value);
 }
 
+inline	Tableau &	Player::GetTableau	(void)
+{
+	return MyTableau;
+}
+
 inline	int		Player::GetMileage		(void)				const
 {
 	return MyTableau.GetMileage();
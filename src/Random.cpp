@@ -0,0 +1,91 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Random.h"
+#include "Thread.h"
+#include <time.h>
+
+namespace _SDLMille
+{
+
+		Random::Random		(void)
+{
+	Seed(MakeSeed());
+}
+
+		Random::Random		(Uint64 NewSeed)
+{
+	Seed(NewSeed);
+}
+
+Uint32	Random::Below		(Uint32 Bound)
+{
+	/*	Lemire's multiply-and-shift. Plain modulo favours small results whenever Bound
+		doesn't divide 2^32; rejecting the few low products that cause it removes the bias. */
+	Uint64	Product = (Next() >> 32) * Bound;
+	Uint32	Low = (Uint32) Product;
+
+	if (Low < Bound)
+	{
+		Uint32	Threshold = (0 - Bound) % Bound;
+
+		while (Low < Threshold)
+		{
+			Product = (Next() >> 32) * Bound;
+			Low = (Uint32) Product;
+		}
+	}
+
+	return (Uint32) (Product >> 32);
+}
+
+Uint64	Random::MakeSeed	(void)
+{
+	/*	For games nobody asked to replay. The counter keeps two decks created in the same
+		clock tick apart, even on different threads. */
+	static	volatile Uint32	Counter = 0;
+	Uint64	Value = ((Uint64) time(NULL) << 20) ^ (Uint64) clock() ^ ((Uint64) Thread::Increment(Counter) * 0x9E3779B97F4A7C15ULL);
+
+	return Mix(Value);
+}
+
+Uint64	Random::Mix			(Uint64 &Value)
+{
+	// SplitMix64: advances Value and returns a well-scrambled function of it
+	Uint64	Result = (Value += 0x9E3779B97F4A7C15ULL);
+
+	Result = (Result ^ (Result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	Result = (Result ^ (Result >> 27)) * 0x94D049BB133111EBULL;
+
+	return Result ^ (Result >> 31);
+}
+
+void	Random::Seed		(Uint64 NewSeed)
+{
+	Uint64	Value = NewSeed;
+
+	SeedValue = NewSeed;
+
+	// SplitMix64 never yields four zero words, which is the one state xoshiro can't leave
+	for (int i = 0; i < 4; ++i)
+		State[i] = Mix(Value);
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_RANDOM_H
+#define	_SDLMILLE_RANDOM_H
+
+#include "Types.h"
+
+namespace _SDLMille
+{
+
+/*	xoshiro256** by Blackman and Vigna, seeded through SplitMix64. Each Deck owns one, so
+	games are reproducible from their seed and threads never share generator state. */
+
+class Random
+{
+public:
+				Random			(void);
+	explicit	Random			(Uint64 NewSeed);
+	Uint32		Below			(Uint32 Bound);
+	Uint64		GetSeed			(void)						const;
+	Uint64		Next			(void);
+	void		Seed			(Uint64 NewSeed);
+
+	static	Uint64	MakeSeed	(void);
+	static	Uint64	Mix			(Uint64 &Value);
+private:
+	static	Uint64	Rotate		(Uint64 Value, int Count);
+
+	Uint64		State[4],
+				SeedValue;
+};
+
+inline	Uint64	Random::GetSeed	(void)						const
+{
+	return SeedValue;
+}
+
+inline	Uint64	Random::Next	(void)
+{
+	Uint64	Result = Rotate(State[1] * 5, 7) * 9,
+			Shifted = State[1] << 17;
+
+	State[2] ^= State[0];
+	State[3] ^= State[1];
+	State[1] ^= State[2];
+	State[0] ^= State[3];
+	State[2] ^= Shifted;
+	State[3] = Rotate(State[3], 45);
+
+	return Result;
+}
+
+inline	Uint64	Random::Rotate	(Uint64 Value, int Count)
+{
+	return (Value << Count) | (Value >> (64 - Count));
+}
+
+}
+
+#endif
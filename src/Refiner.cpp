@@ -0,0 +1,185 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Refiner.h"
+#include "Thread.h"
+#include <math.h>
+
+namespace _SDLMille
+{
+
+		Refiner::Refiner		(void)
+{
+	ActionCount = 0;
+	Base = 0;
+	RootPlayer = 0;
+	Rounds = 0;
+}
+
+bool	Refiner::Begin			(const Engine &Position, Uint8 Proposed)
+{
+	/*	Without a proposal, the first legal move stands in for one; the ranking doesn't
+		depend on which move the others are measured against. */
+	Uint8	Value = CARD_NULL_NULL,
+			Target = 0;
+
+	ActionCount = 0;
+	Base = 0;
+	Rounds = 0;
+	RootPlayer = Position.GetCurrent();
+
+	if (Proposed < MOVE_COUNT)
+	{
+		Value = Position.GetPlayer(RootPlayer).GetValue(Proposed % DISCARD_OFFSET);
+		Target = (Value * 2) + ((Proposed >= DISCARD_OFFSET) ? 1 : 0);
+
+		if (Value >= CARD_NULL_NULL)
+			return false;
+	}
+
+	if (!View.Observe(Position, RootPlayer))
+		return false;
+
+	ActionCount = Search::GetActions(Position, Actions);
+
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		Moves[i] = Search::ToMove(Position, Actions[i]);
+		Sums[i] = Squares[i] = 0;
+
+		if ((Proposed < MOVE_COUNT) && (Actions[i] == Target))
+			Base = i + 1;
+	}
+
+	// A proposal that isn't a legal move is not ours to fix
+	if (Proposed < MOVE_COUNT)
+	{
+		if (Base == 0)
+			return false;
+
+		--Base;
+	}
+
+	Generator.Seed(Position.GetHash());	// The same position thinks the same thoughts
+
+	return ActionCount > 0;
+}
+
+Uint8	Refiner::ChooseMove		(const Engine &Position, Uint8 Proposed, Uint32 Milliseconds)
+{
+	Uint32	Start = Thread::GetMilliseconds();
+	Uint8	Best = MOVE_NONE;
+	double	BestMean = 0;
+
+	if ((Milliseconds == 0) || !Begin(Position, Proposed) || (ActionCount < 2))
+		return Proposed;
+
+	while ((Thread::GetMilliseconds() - Start) < Milliseconds)
+		Step();
+
+	if (Rounds < REFINER_MIN_ROUNDS)
+		return Proposed;
+
+	// Only a move whose lead over the proposal is clear of the noise may replace it
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		double	Mean = Sums[i] / Rounds,
+				Variance = (Squares[i] / Rounds) - (Mean * Mean);
+
+		if ((Mean > BestMean) && (Mean > REFINER_Z * sqrt(std::max(Variance, 0.0) / Rounds)))
+		{
+			BestMean = Mean;
+			Best = Moves[i];
+		}
+	}
+
+	return (Best != MOVE_NONE) ? Best : Proposed;
+}
+
+Uint8	Refiner::GetRanking		(Uint8 *Ranked)			const
+{
+	// Every legal move, best average first
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		int		j = i;
+
+		for (; (j > 0) && (Sums[Ranked[j - 1]] < Sums[i]); --j)
+			Ranked[j] = Ranked[j - 1];
+
+		Ranked[j] = i;
+	}
+
+	for (int i = 0; i < ActionCount; ++i)
+		Ranked[i] = Moves[Ranked[i]];
+
+	return ActionCount;
+}
+
+void	Refiner::Step			(void)
+{
+	// One more deal, with every move played out on it
+	int		Scores[SEARCH_ACTION_COUNT];
+
+	if (ActionCount == 0)
+		return;
+
+	View.Sample(Generator, Deal);
+
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		Engine	Child = Deal;
+
+		Child.OnMove(Moves[i]);
+		Scores[i] = Rollout(Child);
+	}
+
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		double	Difference = Scores[i] - Scores[Base];
+
+		Sums[i] += Difference;
+		Squares[i] += Difference * Difference;
+	}
+
+	++Rounds;
+}
+
+/* Private methods */
+
+int		Refiner::Rollout		(Engine &Position)		const
+{
+	// Finishes the hand, and returns its score difference for the player who is refining
+	Uint32	MoveCount = 0;
+
+	while (!Position.IsHandOver())
+	{
+		if (Position.IsExtensionPending())
+			Position.Extend(Position.ComputerDecideExtension());
+		else if (Position.GetPlayer(Position.GetCurrent()).IsOutOfCards())
+			Position.ChangePlayer();
+		else if (!Position.OnMove(Position.ComputerSmartMove()) || (++MoveCount > REFINER_ROLLOUT_LIMIT))
+			break;
+	}
+
+	Position.GetScores();
+
+	return Position.GetScore(RootPlayer) - Position.GetScore(1 - RootPlayer);
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_REFINER_H
+#define	_SDLMILLE_REFINER_H
+
+#include "Search.h"
+
+namespace _SDLMille
+{
+
+const	Uint32	REFINER_MIN_ROUNDS = 16,		// Deals before any move may overrule the proposal
+				REFINER_ROLLOUT_LIMIT = 1000;	// Moves; same guard as the simulator
+const	double	REFINER_Z = 1.96;				// How sure a move must be before it replaces the proposal
+
+/*	Makes the most of spare time for DIFFICULTY_HARD. ComputerSmartMove proposes a move in
+	microseconds; until the deadline, the refiner deals the hidden cards again and again and,
+	on each deal, plays every legal move and finishes the hand with ComputerSmartMove on both
+	sides. Every move sees the same deals, so what is compared is the difference each one
+	makes against the proposal. The proposal stands unless another move beats it by a clear
+	margin, which keeps Hard's character when there is little time and keeps bad luck in a few
+	rollouts from talking it out of a good move.
+
+	Begin, Step and GetRanking run the same comparison a deal at a time, for callers that
+	decide for themselves when to stop, such as the hints for the human player. */
+
+class Refiner
+{
+public:
+				Refiner			(void);
+	bool		Begin			(const Engine &Position, Uint8 Proposed = MOVE_NONE);
+	Uint8		ChooseMove		(const Engine &Position, Uint8 Proposed, Uint32 Milliseconds);
+	Uint8		GetRanking		(Uint8 *Ranked)			const;
+	Uint32		GetRounds		(void)					const;
+	void		Step			(void);
+private:
+	int			Rollout			(Engine &Position)		const;
+
+	Engine		Deal;
+	Random		Generator;
+	Uint8		Actions[SEARCH_ACTION_COUNT],
+				ActionCount,
+				Base,					// Index of the proposal in Actions
+				Moves[SEARCH_ACTION_COUNT],
+				RootPlayer;
+	Uint32		Rounds;
+	double		Squares[SEARCH_ACTION_COUNT],
+				Sums[SEARCH_ACTION_COUNT];	// Score differences against the proposal, summed over deals
+	Sampler		View;
+};
+
+inline	Uint32	Refiner::GetRounds		(void)			const
+{
+	return Rounds;
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Sampler.h"
+
+namespace _SDLMille
+{
+
+		Sampler::Sampler		(void)
+{
+	HiddenCount = 0;
+	Observer = 0;
+	UnseenCount = 0;
+}
+
+bool	Sampler::Observe		(const Engine &Position, Uint8 NewObserver)
+{
+	GameState	State;
+	Uint8		First = 0;
+
+	if (NewObserver >= PLAYER_COUNT)
+		return false;
+
+	Position.Pack(State);
+
+	Base = Position;
+	Base.SetObserving(false);	// Samples are dealt uniformly, so reading them for tells would be wasted work
+	Base.SetTrace(0);			// Nor are their decisions the ones being explained
+	Base.SetCache(0);			// And random deals almost never repeat a decision, so looking them up only costs
+	Observer = NewObserver;
+	HiddenCount = 0;
+	UnseenCount = 0;
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (State.Players[1 - Observer].Cards[i] < CARD_NULL_NULL)
+			HiddenSlots[HiddenCount++] = i;
+	}
+
+	/*	Unseen means not on either tableau or the discard pile (ExposedCards covers those) and
+		not in the observer's hand. STD_DECK is sorted by value, so any Unseen copies of a value
+		can stand for the real ones. */
+	for (int i = 0; i < CARD_NULL_NULL; ++i)
+	{
+		int	Count = EXISTING_CARDS[i] - GetNibble(State.ExposedCards, i) - Position.GetPlayer(Observer).GetCount(i);
+
+		if (Count < 0)
+			return false;
+
+		for (int j = 0; j < Count; ++j)
+			Unseen[UnseenCount++] = First + j;
+
+		First += EXISTING_CARDS[i];
+	}
+
+	// Every unseen card has to be either in the hidden hand or still in the deck
+	return UnseenCount == (HiddenCount + State.CardsLeft);
+}
+
+void	Sampler::Sample		(Random &Generator, Engine &Out)	const
+{
+	Uint8	Cards[HAND_SIZE],
+			Shuffled[DECK_SIZE];
+
+	for (int i = 0; i < UnseenCount; ++i)
+		Shuffled[i] = Unseen[i];
+
+	// Fisher-Yates: a uniform order of the unseen cards, whose front becomes the hidden hand
+	for (int i = UnseenCount - 1; i > 0; --i)
+	{
+		int		Other = Generator.Below(i + 1);
+		Uint8	Swap = Shuffled[i];
+
+		Shuffled[i] = Shuffled[Other];
+		Shuffled[Other] = Swap;
+	}
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+		Cards[i] = CARD_NULL_NULL;
+
+	for (int i = 0; i < HiddenCount; ++i)
+		Cards[HiddenSlots[i]] = STD_DECK[Shuffled[i]];
+
+	Out = Base;
+	Out.Redeal(1 - Observer, Cards, Shuffled + HiddenCount, UnseenCount - HiddenCount);
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_SAMPLER_H
+#define	_SDLMILLE_SAMPLER_H
+
+#include "Engine.h"
+
+namespace _SDLMille
+{
+
+/*	Deals the cards one player can't see. Observe takes that player's view once; each Sample
+	then gives the other player a uniformly random hand from the unseen cards and stacks the
+	rest as the draw pile, on a copy of the observed position. Everything lives in fixed
+	arrays, so sampling never touches the heap and is cheap enough to call for every playout. */
+
+class Sampler
+{
+public:
+				Sampler		(void);
+	Uint8		GetObserver	(void)								const;
+	Uint8		GetUnseenCount	(void)							const;
+	bool		Observe		(const Engine &Position, Uint8 NewObserver);
+	void		Sample		(Random &Generator, Engine &Out)	const;
+private:
+	Engine		Base;
+	Uint8		HiddenSlots[HAND_SIZE],	// Slots of the hidden hand that hold a card
+				HiddenCount,
+				Observer,
+				Unseen[DECK_SIZE],		// STD_DECK index of every card the observer can't see
+				UnseenCount;
+};
+
+inline	Uint8	Sampler::GetObserver	(void)		const
+{
+	return Observer;
+}
+
+inline	Uint8	Sampler::GetUnseenCount	(void)		const
+{
+	return UnseenCount;
+}
+
+}
+
+#endif
@@ -0,0 +1,414 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Search.h"
+#include <math.h>
+
+namespace _SDLMille
+{
+
+const PositionEvaluator	*Search::DefaultEvaluator = 0;
+Uint32	Search::DefaultPlayouts = SEARCH_DEFAULT_PLAYOUTS;
+Uint32	Search::DefaultMilliseconds = 0;
+Uint8	Search::DefaultThreadCount = 0;	// One per processor
+
+		Search::Search			(void)
+{
+	Budget = DefaultPlayouts;
+	Evaluator = DefaultEvaluator;
+	MillisecondBudget = DefaultMilliseconds;
+	SetThreadCount((DefaultThreadCount > 0) ? DefaultThreadCount : Thread::GetProcessorCount());
+	Seed = 0;
+
+	Elapsed = 0;
+	Playouts = 0;
+	RootPlayer = 0;
+	Start = 0;
+}
+
+Uint8	Search::ChooseMove		(const Engine &Position)
+{
+	Uint8	Actions[SEARCH_ACTION_COUNT],
+			ActionCount = GetActions(Position, Actions),
+			Best = 0;
+	Uint32	Visits[SEARCH_ACTION_COUNT];
+	Uint64	Stream = Position.GetSeed() ^ Seed;
+	Worker	*Workers;
+
+	Playouts = 0;
+	Elapsed = 0;
+
+	// Nothing to think about
+	if (ActionCount == 0)
+		return Position.ComputerMove();
+	if (ActionCount == 1)
+		return ToMove(Position, Actions[0]);
+
+	Start = Thread::GetMilliseconds();
+	RootPlayer = Position.GetCurrent();
+
+	// A position the cards don't add up in can't be sampled, so fall back on the heuristics
+	if (!View.Observe(Position, RootPlayer))
+		return Position.ComputerSmartMove();
+
+	/*	Like Refiner and ExtensionEvaluator, the same position in the same game thinks the
+		same thoughts, whatever searched before it and whichever thread asks, so a seed
+		replays Expert's games too. */
+	Stream = Random::Mix(Stream) ^ Position.GetHash();
+
+	Workers = new Worker[ThreadCount];
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		Workers[i].Owner = this;
+		Workers[i].Generator.Seed(Random::Mix(Stream));
+		Workers[i].Playouts = 0;
+	}
+
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Start(WorkerMain, &Workers[i]);
+
+	WorkerMain(&Workers[0]);
+
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Wait();
+
+	// Sum the root's children over every tree and take the most visited action
+	for (int i = 0; i < SEARCH_ACTION_COUNT; ++i)
+		Visits[i] = 0;
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		std::vector<Node>	&Tree = Workers[i].Tree;
+
+		for (int Child = Tree[0].FirstChild; Child >= 0; Child = Tree[Child].NextSibling)
+			Visits[Tree[Child].Action] += Tree[Child].Visits;
+
+		Playouts += Workers[i].Playouts;
+	}
+
+	delete[] Workers;
+
+	for (int i = 1; i < ActionCount; ++i)
+	{
+		if (Visits[Actions[i]] > Visits[Actions[Best]])
+			Best = i;
+	}
+
+	Elapsed = Thread::GetMilliseconds() - Start;
+
+	return ToMove(Position, Actions[Best]);
+}
+
+void	Search::SetBudget		(Uint32 NewPlayouts, Uint32 NewMilliseconds)
+{
+	Budget = NewPlayouts;
+	MillisecondBudget = NewMilliseconds;
+
+	if ((Budget == 0) && (MillisecondBudget == 0))
+		Budget = SEARCH_DEFAULT_PLAYOUTS;
+}
+
+void	Search::SetDefaultEvaluator	(const PositionEvaluator *NewEvaluator)
+{
+	// Like SetDefaults; the evaluator must outlive every Search that uses it
+	DefaultEvaluator = NewEvaluator;
+}
+
+void	Search::SetDefaults		(Uint32 NewPlayouts, Uint32 NewMilliseconds, Uint8 NewThreadCount)
+{
+	// Applies to every Search created afterwards, including the one behind ComputerChooseMove
+	DefaultPlayouts = NewPlayouts;
+	DefaultMilliseconds = NewMilliseconds;
+	DefaultThreadCount = NewThreadCount;
+
+	if ((DefaultPlayouts == 0) && (DefaultMilliseconds == 0))
+		DefaultPlayouts = SEARCH_DEFAULT_PLAYOUTS;
+}
+
+void	Search::SetSeed			(Uint64 NewSeed)
+{
+	// Mixed in with the game's seed and the position, for different thoughts about the same one
+	Seed = NewSeed;
+}
+
+void	Search::SetThreadCount	(Uint8 NewThreadCount)
+{
+	if (NewThreadCount < 1)
+		ThreadCount = 1;
+	else if (NewThreadCount > SEARCH_THREAD_MAX)
+		ThreadCount = SEARCH_THREAD_MAX;
+	else
+		ThreadCount = NewThreadCount;
+}
+
+Uint8	Search::ToMove			(const Engine &Position, Uint8 Action)
+{
+	Uint8	Value = Action / 2;
+	bool	Discarding = (Action % 2) == 1;
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		if (Position.GetPlayer(Position.GetCurrent()).GetValue(i) == Value)
+		{
+			if (Discarding)
+				return i + DISCARD_OFFSET;
+			if (Position.IsValidPlay(i))
+				return i;
+		}
+	}
+
+	return MOVE_NONE;
+}
+
+/* Private methods */
+
+Uint8	Search::GetActions		(const Engine &Position, Uint8 *Actions)
+{
+	const Player	&Mover = Position.GetPlayer(Position.GetCurrent());
+	bool			Seen[SEARCH_ACTION_COUNT] = {false};
+	Uint8			Count = 0;
+
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		Uint8	Value = Mover.GetValue(i),
+				Play = Value * 2,
+				Discard = Play + 1;
+
+		if (Value >= CARD_NULL_NULL)
+			continue;
+
+		if (!Seen[Play] && Position.IsValidPlay(i))
+		{
+			Seen[Play] = true;
+			Actions[Count++] = Play;
+		}
+
+		// Safeties can't be discarded
+		if (!Seen[Discard] && (Card::GetTypeFromValue(Value) != CARD_SAFETY))
+		{
+			Seen[Discard] = true;
+			Actions[Count++] = Discard;
+		}
+	}
+
+	return Count;
+}
+
+bool	Search::OutOfBudget		(Uint32 WorkerPlayouts)	const
+{
+	if (WorkerPlayouts == 0)
+		return false;
+
+	if ((Budget > 0) && (WorkerPlayouts >= (Budget + ThreadCount - 1) / ThreadCount))
+		return true;
+
+	// The clock is cheap, but not so cheap that it's worth reading after every playout
+	if ((MillisecondBudget > 0) && ((WorkerPlayouts % 16) == 0))
+		return (Thread::GetMilliseconds() - Start) >= MillisecondBudget;
+
+	return false;
+}
+
+void	Search::Playout			(Worker &Self, Engine &Position)
+{
+	std::vector<Node>	&Tree = Self.Tree;
+	int					Current = 0;
+	double				Reward;
+
+	View.Sample(Self.Generator, Position);
+
+	Self.Path.clear();
+	Self.Path.push_back(Current);
+
+	// Selection and expansion
+	for (;;)
+	{
+		Uint8	Actions[SEARCH_ACTION_COUNT],
+				ActionCount,
+				Untried[SEARCH_ACTION_COUNT],
+				UntriedCount = 0;
+		bool	Legal[SEARCH_ACTION_COUNT] = {false},
+				Tried[SEARCH_ACTION_COUNT] = {false};
+		int		Best = -1;
+		double	BestScore = 0;
+
+		Settle(Position);
+		if (Position.IsHandOver())
+			break;
+
+		ActionCount = GetActions(Position, Actions);
+		if (ActionCount == 0)
+			break;
+
+		for (int i = 0; i < ActionCount; ++i)
+			Legal[Actions[i]] = true;
+
+		// Children are only available in deals where their action is legal
+		for (int Child = Tree[Current].FirstChild; Child >= 0; Child = Tree[Child].NextSibling)
+		{
+			Node	&Candidate = Tree[Child];
+
+			if (!Legal[Candidate.Action])
+				continue;
+
+			Tried[Candidate.Action] = true;
+			++Candidate.Availability;
+		}
+
+		for (int i = 0; i < ActionCount; ++i)
+		{
+			if (!Tried[Actions[i]])
+				Untried[UntriedCount++] = Actions[i];
+		}
+
+		if (UntriedCount > 0)
+		{
+			Node	Expanded;
+
+			Expanded.Action = Untried[Self.Generator.Below(UntriedCount)];
+			Expanded.Player = Position.GetCurrent();
+			Expanded.Reward = 0;
+			Expanded.Availability = 1;
+			Expanded.Visits = 0;
+			Expanded.FirstChild = -1;
+			Expanded.NextSibling = Tree[Current].FirstChild;
+
+			Tree.push_back(Expanded);
+			Tree[Current].FirstChild = Tree.size() - 1;
+			Current = Tree.size() - 1;
+
+			Self.Path.push_back(Current);
+			Position.OnMove(ToMove(Position, Expanded.Action));
+			break;
+		}
+
+		for (int Child = Tree[Current].FirstChild; Child >= 0; Child = Tree[Child].NextSibling)
+		{
+			Node	&Candidate = Tree[Child];
+			double	Score;
+
+			if (!Legal[Candidate.Action])
+				continue;
+
+			Score = (Candidate.Reward / Candidate.Visits) + SEARCH_EXPLORATION * sqrt(log((double) Candidate.Availability) / Candidate.Visits);
+
+			if ((Best < 0) || (Score > BestScore))
+			{
+				Best = Child;
+				BestScore = Score;
+			}
+		}
+
+		Current = Best;
+		Self.Path.push_back(Current);
+
+		if (!Position.OnMove(ToMove(Position, Tree[Current].Action)))
+			break;
+	}
+
+	Reward = Rollout(Position);
+
+	// Each node scores the playout from the point of view of the player who chose it
+	for (size_t i = 0; i < Self.Path.size(); ++i)
+	{
+		Node	&Visited = Tree[Self.Path[i]];
+
+		++Visited.Visits;
+		Visited.Reward += (Visited.Player == RootPlayer) ? Reward : (1 - Reward);
+	}
+}
+
+double	Search::Rollout			(Engine &Position)
+{
+	Uint32	Moves = 0;
+	double	Margin, Reward;
+
+	Settle(Position);
+
+	if ((Evaluator != 0) && Evaluator->IsLoaded() && !Position.IsHandOver())
+		Margin = Evaluator->Evaluate(Position, RootPlayer);
+	else
+	{
+		for (;;)
+		{
+			Settle(Position);
+			if (Position.IsHandOver())
+				break;
+
+			if (!Position.OnMove(Position.ComputerMove()) || (++Moves > SEARCH_ROLLOUT_LIMIT))
+				break;
+		}
+
+		Position.GetScores();
+		Margin = Position.GetScore(RootPlayer) - Position.GetScore(1 - RootPlayer);
+	}
+
+	Reward = 0.5 + Margin / SEARCH_SCORE_SCALE;
+
+	if (Reward < 0)
+		return 0;
+	if (Reward > 1)
+		return 1;
+
+	return Reward;
+}
+
+void	Search::Settle			(Engine &Position)
+{
+	// Play out everything that isn't a choice of card: extensions and empty hands
+	while (!Position.IsHandOver())
+	{
+		if (Position.IsExtensionPending())
+			Position.Extend(Position.ComputerDecideExtension());
+		else if (Position.GetPlayer(Position.GetCurrent()).IsOutOfCards())
+			Position.ChangePlayer();
+		else
+			break;
+	}
+}
+
+void	Search::WorkerMain		(void *Data)
+{
+	Worker	&Self = *((Worker *) Data);
+	Search	&Owner = *Self.Owner;
+	Engine	Position(Self.Generator.Next());
+	Node	Top;
+
+	Top.Action = 0;
+	Top.Player = 1 - Owner.RootPlayer;
+	Top.Reward = 0;
+	Top.Availability = 1;
+	Top.Visits = 0;
+	Top.FirstChild = -1;
+	Top.NextSibling = -1;
+
+	Self.Tree.clear();
+	Self.Tree.reserve(((Owner.Budget > 0) ? (Owner.Budget / Owner.ThreadCount) : SEARCH_DEFAULT_PLAYOUTS) + 1);
+	Self.Tree.push_back(Top);
+
+	while (!Owner.OutOfBudget(Self.Playouts))
+	{
+		Owner.Playout(Self, Position);
+		++Self.Playouts;
+	}
+}
+
+}
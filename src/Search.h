@@ -0,0 +1,130 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_SEARCH_H
+#define	_SDLMILLE_SEARCH_H
+
+#include "Evaluator.h"
+#include "Sampler.h"
+#include "Thread.h"
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	Uint32	SEARCH_DEFAULT_PLAYOUTS = 5000,
+				SEARCH_ROLLOUT_LIMIT = 1000;	// Moves; same guard as the simulator
+const	Uint8	SEARCH_ACTION_COUNT = CARD_NULL_NULL * 2,	// Play or discard each card value
+				SEARCH_THREAD_MAX = 64;
+const	double	SEARCH_EXPLORATION = 0.7,
+				SEARCH_SCORE_SCALE = 4000;	// Hand score difference that maps to a certain win
+
+/*	Information-set Monte Carlo Tree Search for DIFFICULTY_EXPERT.
+
+	Each playout deals the cards the searching player can't see (the opponent's hand and the
+	deck) at random, consistent with ExposedCards and its own hand, then walks one shared tree
+	with UCB, counting a child as available only in the deals where it is legal. Actions are
+	card values rather than hand slots, so "play a 100" means the same thing in every deal.
+	Playouts finish the hand with ComputerMove and score the hand difference, or, when a
+	PositionEvaluator has been given, stop where the tree ends and take its estimate instead.
+
+	Root parallel: each thread grows its own tree and the root visit counts are summed. */
+
+class Search
+{
+public:
+				Search			(void);
+	Uint8		ChooseMove		(const Engine &Position);
+	Uint32		GetMilliseconds	(void)					const;
+	Uint32		GetPlayouts		(void)					const;
+	void		SetBudget		(Uint32 NewPlayouts, Uint32 NewMilliseconds = 0);
+	void		SetEvaluator	(const PositionEvaluator *NewEvaluator);
+	void		SetSeed			(Uint64 NewSeed);
+	void		SetThreadCount	(Uint8 NewThreadCount);
+
+	static	Uint8	GetActions	(const Engine &Position, Uint8 *Actions);
+	static	void	SetDefaultEvaluator	(const PositionEvaluator *NewEvaluator);
+	static	void	SetDefaults	(Uint32 NewPlayouts, Uint32 NewMilliseconds, Uint8 NewThreadCount);
+	static	Uint8	ToMove		(const Engine &Position, Uint8 Action);
+private:
+	struct Node
+	{
+		double	Reward;			// Total, from the point of view of the player who moved
+		Uint32	Availability,
+				Visits;
+		int		FirstChild,
+				NextSibling;
+		Uint8	Action,
+				Player;
+	};
+
+	struct Worker
+	{
+		Search			*Owner;
+		Thread			Runner;
+		Random			Generator;
+		std::vector<Node>	Tree;
+		std::vector<int>	Path;
+		Uint32			Playouts;
+	};
+
+	static	void	Settle		(Engine &Position);
+
+	bool		OutOfBudget		(Uint32 Playouts)		const;
+	void		Playout			(Worker &Self, Engine &Position);
+	double		Rollout			(Engine &Position);
+
+	static	void	WorkerMain	(void *Data);
+
+	Uint8		RootPlayer,
+				ThreadCount;
+	Uint32		Budget,
+				Elapsed,
+				MillisecondBudget,
+				Playouts,
+				Start;
+	Sampler		View;
+	Uint64		Seed;
+	const PositionEvaluator	*Evaluator;	// Leaf values in place of rollouts, or 0
+
+	static	const PositionEvaluator	*DefaultEvaluator;
+	static	Uint32	DefaultPlayouts,
+					DefaultMilliseconds;
+	static	Uint8	DefaultThreadCount;
+};
+
+inline	Uint32	Search::GetMilliseconds	(void)			const
+{
+	return Elapsed;
+}
+
+inline	Uint32	Search::GetPlayouts		(void)			const
+{
+	return Playouts;
+}
+
+inline	void	Search::SetEvaluator	(const PositionEvaluator *NewEvaluator)
+{
+	Evaluator = NewEvaluator;
+}
+
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Simulator.h"
+
+namespace _SDLMille
+{
+
+		Simulator::Simulator	(void)
+{
+	Recorder = 0;
+	ThinkTime = 0;
+	Clear();
+}
+
+void	Simulator::Clear		(void)
+{
+	Errors = 0;
+	Games = 0;
+	Hands = 0;
+	Moves = 0;
+
+	for (int i = 0; i <= OUTCOME_NOT_OVER; ++i)
+		Outcomes[i] = 0;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		ScoreSquares[i] = 0;
+		ScoreTotals[i] = 0;
+	}
+}
+
+Uint8	Simulator::PlayGame		(Engine &Rules, const Uint8 *Levels)
+{
+	Uint8	Outcome = OUTCOME_NOT_OVER;
+
+	// Play hands until somebody reaches 5000. Outcomes are from the first player's point of view.
+	while (Outcome == OUTCOME_NOT_OVER)
+	{
+		if (!PlayHand(Rules, Levels))
+		{
+			if (Recorder != 0)
+				Recorder->Abandon();
+
+			++Errors;
+			break;
+		}
+
+		Outcome = Rules.GetOutcome();
+
+		// Rolls up the score, or clears it for the next game once this one is decided
+		Rules.Reset();
+	}
+
+	if ((Recorder != 0) && (Outcome != OUTCOME_NOT_OVER))
+		Recorder->OnGameOver(Outcome);
+
+	++Games;
+	++Outcomes[Outcome];
+
+	return Outcome;
+}
+
+bool	Simulator::PlayHand		(Engine &Rules, const Uint8 *Levels)
+{
+	Uint32	MoveCount = 0;
+	Uint8	Move;
+
+	while (!Rules.IsHandOver())
+	{
+		Uint8	Current = Rules.GetCurrent();
+
+		if (Rules.IsExtensionPending())
+		{
+			Rules.Extend(Rules.ComputerChooseExtension(Levels[Current], ThinkTime));
+			continue;
+		}
+
+		if (Rules.GetPlayer(Current).IsOutOfCards())
+		{
+			Rules.ChangePlayer();
+			continue;
+		}
+
+		Move = Rules.ComputerChooseMove(Levels[Current], ThinkTime);
+
+		if (Recorder != 0)
+			Recorder->OnMove(Rules, Levels[Current], Move);
+
+		if (!Rules.OnMove(Move) || (++MoveCount > SIMULATOR_MOVE_LIMIT))
+			return false;
+	}
+
+	Rules.GetScores();
+
+	if (Recorder != 0)
+		Recorder->OnHandOver(Rules);
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		double	Score = Rules.GetScore(i);
+
+		ScoreSquares[i] += Score * Score;
+		ScoreTotals[i] += Score;
+	}
+
+	++Hands;
+	Moves += MoveCount;
+
+	return true;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_SIMULATOR_H
+#define	_SDLMILLE_SIMULATOR_H
+
+#include "Training.h"
+
+namespace _SDLMille
+{
+
+const	Uint32	SIMULATOR_MOVE_LIMIT = 1000;	// No legal hand comes close; guards against a stuck policy
+
+/*	Plays computer-vs-computer games on an Engine with no presentation attached, and keeps
+	running totals so the caller can report throughput and results. With a recorder set,
+	every move chosen is recorded for training. */
+
+class Simulator
+{
+public:
+				Simulator		(void);
+	void		Clear			(void);
+	Uint32		GetErrors		(void)							const;
+	Uint32		GetGames		(void)							const;
+	Uint32		GetHands		(void)							const;
+	Uint32		GetMoves		(void)							const;
+	Uint32		GetOutcomes		(Uint8 Outcome)					const;
+	double		GetScoreSquares	(Uint8 PlayerIndex)				const;
+	double		GetScoreTotal	(Uint8 PlayerIndex)				const;
+	Uint8		PlayGame		(Engine &Rules, const Uint8 *Levels);
+	bool		PlayHand		(Engine &Rules, const Uint8 *Levels);
+	void		SetRecorder		(TrainingRecorder *NewRecorder);
+	void		SetThinkTime	(Uint32 Milliseconds);
+private:
+	TrainingRecorder	*Recorder;
+	Uint32		Errors,
+				Games,
+				Hands,
+				Moves,
+				Outcomes[OUTCOME_NOT_OVER + 1],
+				ThinkTime;	// Each move's deadline, for the levels that can use one; 0 for none
+	double		ScoreSquares[PLAYER_COUNT],	// Hand scores, for averages and their spread
+				ScoreTotals[PLAYER_COUNT];
+};
+
+inline	void	Simulator::SetRecorder	(TrainingRecorder *NewRecorder)
+{
+	Recorder = NewRecorder;
+}
+
+inline	void	Simulator::SetThinkTime	(Uint32 Milliseconds)
+{
+	ThinkTime = Milliseconds;
+}
+
+inline	Uint32	Simulator::GetErrors	(void)				const
+{
+	return Errors;
+}
+
+inline	Uint32	Simulator::GetGames		(void)				const
+{
+	return Games;
+}
+
+inline	Uint32	Simulator::GetHands		(void)				const
+{
+	return Hands;
+}
+
+inline	Uint32	Simulator::GetMoves		(void)				const
+{
+	return Moves;
+}
+
+inline	Uint32	Simulator::GetOutcomes	(Uint8 Outcome)		const
+{
+	if (Outcome <= OUTCOME_NOT_OVER)
+		return Outcomes[Outcome];
+
+	return 0;
+}
+
+inline	double	Simulator::GetScoreSquares	(Uint8 PlayerIndex)	const
+{
+	return ScoreSquares[PlayerIndex];
+}
+
+inline	double	Simulator::GetScoreTotal	(Uint8 PlayerIndex)	const
+{
+	return ScoreTotals[PlayerIndex];
+}
+
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Search.h"
+#include "Solver.h"
+
+namespace _SDLMille
+{
+
+		Solver::Solver			(void)
+{
+	Aborted = false;
+	Nodes = 0;
+	Value = 0;
+}
+
+Uint8	Solver::ChooseMove		(const Engine &Position)
+{
+	Sampler	View;
+	Random	Generator(0);	// Only the order of the opponent's hand is random, and that doesn't matter
+	Engine	Exact;
+	Uint8	Actions[SEARCH_ACTION_COUNT],
+			ActionCount;
+	int		Alpha = -SOLVER_SCORE_LIMIT,
+			Best = -1;
+
+	Aborted = false;
+	Nodes = 0;
+	Value = 0;
+
+	if (!IsSolvable(Position) || !View.Observe(Position, Position.GetCurrent()))
+		return MOVE_NONE;
+
+	// With an empty deck there is only one deal, so this is the real position
+	View.Sample(Generator, Exact);
+
+	Table.assign(SOLVER_TABLE_SIZE, Entry());
+	for (Uint32 i = 0; i < SOLVER_TABLE_SIZE; ++i)
+		Table[i].Bound = BOUND_NONE;
+
+	ActionCount = Search::GetActions(Exact, Actions);
+
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		Engine	Child = Exact;
+		int		Score;
+
+		Child.OnMove(Search::ToMove(Child, Actions[i]));
+		Settle(Child);
+
+		if (Child.GetCurrent() == Exact.GetCurrent())
+			Score = Solve(Child, Alpha, SOLVER_SCORE_LIMIT);
+		else
+			Score = -Solve(Child, -SOLVER_SCORE_LIMIT, -Alpha);
+
+		if (Aborted)
+			return MOVE_NONE;
+
+		if ((Best < 0) || (Score > Alpha))
+		{
+			Alpha = Score;
+			Best = i;
+		}
+	}
+
+	if (Best < 0)
+		return MOVE_NONE;
+
+	Value = Alpha;
+
+	return Search::ToMove(Position, Actions[Best]);
+}
+
+bool	Solver::IsSolvable		(const Engine &Position)
+{
+	return (Position.GetCardsLeft() == 0) && !Position.IsHandOver() && !Position.IsExtensionPending();
+}
+
+/* Private methods */
+
+void	Solver::Settle			(Engine &Position)
+{
+	// Passing isn't a decision; the hand ends once both players are out of cards
+	while (!Position.IsHandOver() && !Position.IsExtensionPending() && Position.GetPlayer(Position.GetCurrent()).IsOutOfCards())
+		Position.ChangePlayer();
+}
+
+int		Solver::Solve			(Engine &Position, int Alpha, int Beta)
+{
+	/*	Negamax: the result is the hand score difference from the point of view of the
+		player about to move. Playing a safety keeps the turn, so a child is only negated
+		when the player to move changes. */
+	Uint64		Key;
+	Uint8		Actions[SEARCH_ACTION_COUNT],
+				ActionCount,
+				BestAction = 0;
+	int			OriginalAlpha = Alpha,
+				BestScore = -SOLVER_SCORE_LIMIT;
+	Uint32		Slot;
+	bool		Deciding = Position.IsExtensionPending();
+
+	if (Position.IsHandOver())
+	{
+		Uint8	Mover = Position.GetCurrent();
+
+		Position.GetScores();
+		return Position.GetScore(Mover) - Position.GetScore(1 - Mover);
+	}
+
+	if (++Nodes > SOLVER_NODE_LIMIT)
+	{
+		Aborted = true;
+		return 0;
+	}
+
+	Key = Position.GetHash();
+	Slot = (Uint32) Key & (SOLVER_TABLE_SIZE - 1);
+
+	if ((Table[Slot].Bound != BOUND_NONE) && (Table[Slot].Key == Key))
+	{
+		const Entry	&Stored = Table[Slot];
+
+		if (Stored.Bound == BOUND_EXACT)
+			return Stored.Value;
+		if ((Stored.Bound == BOUND_LOWER) && (Stored.Value >= Beta))
+			return Stored.Value;
+		if ((Stored.Bound == BOUND_UPPER) && (Stored.Value <= Alpha))
+			return Stored.Value;
+
+		BestAction = Stored.Action;
+	}
+
+	// Whoever just completed the trip chooses whether to extend it; 0 declines and 1 extends
+	if (Deciding)
+	{
+		Actions[0] = 0;
+		Actions[1] = 1;
+		ActionCount = 2;
+	}
+	else
+		ActionCount = Search::GetActions(Position, Actions);
+
+	// Try the best action from an earlier visit first
+	for (int i = 1; i < ActionCount; ++i)
+	{
+		if (Actions[i] == BestAction)
+		{
+			Actions[i] = Actions[0];
+			Actions[0] = BestAction;
+			break;
+		}
+	}
+
+	for (int i = 0; i < ActionCount; ++i)
+	{
+		Engine	Child = Position;
+		int		Score;
+
+		if (Deciding)
+			Child.Extend(Actions[i] == 1);
+		else
+			Child.OnMove(Search::ToMove(Child, Actions[i]));
+
+		Settle(Child);
+
+		if (Child.GetCurrent() == Position.GetCurrent())
+			Score = Solve(Child, Alpha, Beta);
+		else
+			Score = -Solve(Child, -Beta, -Alpha);
+
+		if (Aborted)
+			return 0;
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestAction = Actions[i];
+		}
+
+		if (Score > Alpha)
+			Alpha = Score;
+
+		if (Alpha >= Beta)
+			break;
+	}
+
+	Table[Slot].Key = Key;
+	Table[Slot].Value = BestScore;
+	Table[Slot].Action = BestAction;
+
+	if (BestScore <= OriginalAlpha)
+		Table[Slot].Bound = BOUND_UPPER;
+	else if (BestScore >= Beta)
+		Table[Slot].Bound = BOUND_LOWER;
+	else
+		Table[Slot].Bound = BOUND_EXACT;
+
+	return BestScore;
+}
+
+}
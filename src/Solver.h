@@ -0,0 +1,85 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_SOLVER_H
+#define	_SDLMILLE_SOLVER_H
+
+#include "Sampler.h"
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	int		SOLVER_SCORE_LIMIT = 30000;	// Beyond any hand score difference
+const	Uint32	SOLVER_NODE_LIMIT = 500000,
+				SOLVER_TABLE_SIZE = 1 << 16;	// Entries; a power of two
+
+/*	Exact alpha-beta search for the end of a hand. Once the draw pile is empty, every card
+	the mover can't see is in the opponent's hand, so the rest of the hand is a game of
+	perfect information. Positions are scored by hand score difference, using the engine's
+	own rules and GetScores, so coups fourrés, extensions and the delayed action, safe trip
+	and shutout bonuses are all played exactly. The transposition table is keyed by
+	Engine::GetHash.
+
+	ChooseMove returns MOVE_NONE if the deck isn't empty yet or the search runs past
+	SOLVER_NODE_LIMIT, and the caller should fall back on its usual move. */
+
+class Solver
+{
+public:
+				Solver			(void);
+	Uint8		ChooseMove		(const Engine &Position);
+	Uint32		GetNodes		(void)					const;
+	int			GetValue		(void)					const;
+
+	static	bool	IsSolvable	(const Engine &Position);
+private:
+	enum	{BOUND_NONE = 0, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER};
+
+	struct Entry
+	{
+		Uint64		Key;	// Engine::GetHash
+		Sint16		Value;
+		Uint8		Action,
+					Bound;
+	};
+
+	static	void	Settle		(Engine &Position);
+
+	int			Solve			(Engine &Position, int Alpha, int Beta);
+
+	bool		Aborted;
+	Uint32		Nodes;
+	int			Value;
+	std::vector<Entry>	Table;
+};
+
+inline	Uint32	Solver::GetNodes		(void)			const
+{
+	return Nodes;
+}
+
+inline	int		Solver::GetValue		(void)			const
+{
+	return Value;
+}
+
+}
+
+#endif
@@ -20,9 +20,10 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef	_SDLMILLE_STATS_H
 #define	_SDLMILLE_STATS_H
 
+#include <stdio.h>
 #include <sys/stat.h>
 //#include <fstream>
-#include <SDL.h>
+#include "Types.h"
 
 namespace	_SDLMille
 {
@@ -18,6 +18,9 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "Surface.h"
+#include "GlyphAtlas.h"
+#include "ImageCache.h"
+#include <algorithm>
 
 namespace _SDLMille
 {
@@ -30,12 +33,17 @@ namespace _SDLMille
 	Length = 0;
 	X = 0;
 	Y = 0;
+	Stamp = 0;
+	Shared = false;
+	Part.x = 0;
+	Part.y = 0;
+	Part.w = 0;
+	Part.h = 0;
 }
 
 				Surface::~Surface		(void)
 {
-	if (MySurface != 0)
-		SDL_FreeSurface(MySurface);
+	Release();
 
 	if (Cached != 0)
 		delete [] Cached;
@@ -52,11 +60,7 @@ void			Surface::Center			(Uint8 CenterMode)
 
 void			Surface::Clear			(void)
 {
-	if (MySurface != 0)
-	{
-		SDL_FreeSurface(MySurface);
-		MySurface = 0;
-	}
+	Release();
 
 	if (Cached != 0)
 	{
@@ -66,7 +70,7 @@ void			Surface::Clear			(void)
 	}
 }
 
-bool			Surface::Draw			(SDL_Surface * Destination, SDL_Surface * Source, int X, int Y, int ScaleMode, bool Free)
+bool			Surface::Draw			(SDL_Surface * Destination, SDL_Surface * Source, int X, int Y, int ScaleMode, bool Free, const SDL_Rect *Part)
 {
 	if ((Destination == 0) || (Source == 0))
 		return false;
@@ -81,11 +85,18 @@ bool			Surface::Draw			(SDL_Surface * Destination, SDL_Surface * Source, int X,
 			Y *= Scale;
 	}
 
-	SDL_Rect	DestRect;
+	SDL_Rect	DestRect,
+				SourceRect;
 	DestRect.x = X;
 	DestRect.y = Y;
 
-	SDL_BlitSurface(Source, 0, Destination, &DestRect);
+	if (Part != 0)
+	{
+		SourceRect = *Part;
+		SDL_BlitSurface(Source, &SourceRect, Destination, &DestRect);
+	}
+	else
+		SDL_BlitSurface(Source, 0, Destination, &DestRect);
 
 	if (Free)
 		SDL_FreeSurface(Source);
@@ -97,7 +108,27 @@ bool			Surface::DrawPart		(SDL_Rect &SourceRect, SDL_Surface *Destination)
 {
 	if ((MySurface != 0) && (Destination != 0))
 	{
-		SDL_BlitSurface(MySurface, &SourceRect, Destination, 0);
+		SDL_Rect	Sheet = SourceRect;
+
+		// The rectangle is relative to this sprite, so move it onto its cell and keep it there
+		if (Shared)
+		{
+			int	Left = std::max((int) SourceRect.x, 0),
+				Top = std::max((int) SourceRect.y, 0),
+				Right = std::min(SourceRect.x + SourceRect.w, (int) Part.w),
+				Bottom = std::min(SourceRect.y + SourceRect.h, (int) Part.h);
+
+			if ((Right <= Left) || (Bottom <= Top))
+				return true;
+
+			Sheet.x = Part.x + Left;
+			Sheet.y = Part.y + Top;
+			Sheet.w = Right - Left;
+			Sheet.h = Bottom - Top;
+		}
+
+		if (!Compositor::Record(Destination, MySurface, Stamp, &Sheet, 0, 0))
+			SDL_BlitSurface(MySurface, &Sheet, Destination, 0);
 
 		return true;
 	}
@@ -127,6 +158,9 @@ void			Surface::GetCoords		(int &XCoord, int &YCoord)												const
 
 int				Surface::GetHeight		(void)																	const
 {
+	if (Shared)
+		return Part.h;
+
 	if (MySurface != 0)
 		return MySurface->h;
 
@@ -135,6 +169,9 @@ int				Surface::GetHeight		(void)																	const
 
 int				Surface::GetWidth		(void)																	const
 {
+	if (Shared)
+		return Part.w;
+
 	if (MySurface != 0)
 		return MySurface->w;
 
@@ -170,8 +207,10 @@ void			Surface::Render			(SDL_Surface *Destination)												const
 
 void			Surface::Render			(int X, int Y, SDL_Surface * Destination, int ScaleMode)				const
 {
-	if (MySurface != 0)
-		Draw(Destination, MySurface, X, Y, ScaleMode);
+	const SDL_Rect	*Cell = Shared ? &Part : 0;
+
+	if ((MySurface != 0) && !Compositor::Record(Destination, MySurface, Stamp, Cell, X, Y))
+		Draw(Destination, MySurface, X, Y, ScaleMode, false, Cell);
 }
 
 SDL_Surface *	Surface::RenderText		(const char *Text, TTF_Font *Font, SDL_Color *fgColor, SDL_Color *bgColor)
@@ -184,10 +223,16 @@ SDL_Surface *	Surface::RenderText		(const char *Text, TTF_Font *Font, SDL_Color
 
 	if (Font != 0)
 	{
-		if (bgColor == 0)
-			TextSurface = TTF_RenderText_Blended(Font, Text, (*fgColor));
-		else
-			TextSurface = TTF_RenderText_Shaded(Font, Text, (*fgColor), (*bgColor));
+		// Put together from cached glyphs if it can be, so FreeType only sees new fonts and colours
+		TextSurface = GlyphAtlas::Render(Text, Font, (*fgColor), bgColor);
+
+		if (TextSurface == 0)
+		{
+			if (bgColor == 0)
+				TextSurface = TTF_RenderText_Blended(Font, Text, (*fgColor));
+			else
+				TextSurface = TTF_RenderText_Shaded(Font, Text, (*fgColor), (*bgColor));
+		}
 
 		return TextSurface;
 	}
@@ -217,7 +262,7 @@ void			Surface::SetAlpha		(int AlphaValue)
 {
 	SDL_Surface *Temp = 0;
 
-	if (MySurface)
+	if (MySurface && Own())
 	{
 		SDL_SetAlpha(MySurface, SDL_SRCALPHA, AlphaValue);
 		Temp = SDL_DisplayFormat(MySurface);
@@ -226,6 +271,8 @@ void			Surface::SetAlpha		(int AlphaValue)
 			SDL_FreeSurface(MySurface);
 			MySurface = Temp;
 		}
+
+		Stamp = Compositor::NewStamp();
 	}
 }
 
@@ -239,13 +286,20 @@ void			Surface::SetImage		(const char * File)
 {
 	if (CheckCache(File))
 	{
+		Release();
+
+		MySurface = ImageCache::Acquire(File);
+
 		if (MySurface != 0)
 		{
-			SDL_FreeSurface(MySurface);
-			MySurface = 0;
+			Part.x = 0;
+			Part.y = 0;
+			Part.w = MySurface->w;
+			Part.h = MySurface->h;
+			Shared = true;
 		}
 
-		MySurface = Load(File);
+		Stamp = Compositor::NewStamp();
 	}
 }
 
@@ -260,11 +314,7 @@ void			Surface::SetInteger		(int Value, TTF_Font * Font, bool ShowZero, SDL_Colo
 	{
 		Integer = Value;
 
-		if (MySurface != 0)
-		{
-			SDL_FreeSurface(MySurface);
-			MySurface = 0;
-		}
+		Release();
 
 		if (Value == 0)
 		{
@@ -291,6 +341,7 @@ void			Surface::SetInteger		(int Value, TTF_Font * Font, bool ShowZero, SDL_Colo
 		}
 
 		MySurface = RenderText(Text, Font, fgColor, bgColor);
+		Stamp = Compositor::NewStamp();
 	}
 }
 
@@ -305,6 +356,27 @@ void			Surface::SetInteger		(int Value, TTF_Font * Font, bool ShowZero, SDL_Colo
 //	}
 //}
 
+void			Surface::SetSprite		(Uint8 Sprite)
+{
+	if (!CardAtlas::IsLoaded())
+	{
+		SetImage(CardAtlas::GetFile(Sprite));
+		return;
+	}
+
+	if (CheckCache("SPRITE") || (Sprite != Integer))
+	{
+		Integer = Sprite;
+
+		Release();
+
+		MySurface = CardAtlas::GetSheet();
+		Part = CardAtlas::GetRect(Sprite);
+		Shared = true;
+		Stamp = CardAtlas::GetStamp();
+	}
+}
+
 void			Surface::SetText		(const char * Text, TTF_Font * Font, SDL_Color *fgColor, SDL_Color *bgColor)
 {
 	if (Font == 0)
@@ -312,13 +384,10 @@ void			Surface::SetText		(const char * Text, TTF_Font * Font, SDL_Color *fgColor
 
 	if (CheckCache(Text))
 	{
-		if (MySurface != 0)
-		{
-			SDL_FreeSurface(MySurface);
-			MySurface = 0;
-		}
+		Release();
 
 		MySurface = RenderText(Text, Font,fgColor, bgColor);
+		Stamp = Compositor::NewStamp();
 	}
 }
 
@@ -354,4 +423,45 @@ bool			Surface::CheckCache		(const char * Text)
 	return CacheDirty;
 }
 
+bool			Surface::Own			(void)
+{
+	SDL_Surface	*Copy = 0;
+	Uint32		Flags;
+	Uint8		Alpha;
+
+	if (!Shared)
+		return true;
+
+	// Copy the image out of the atlas or the cache, so changing it leaves everyone else's alone
+	Copy = SDL_CreateRGBSurface(SDL_SWSURFACE, Part.w, Part.h, MySurface->format->BitsPerPixel,
+		MySurface->format->Rmask, MySurface->format->Gmask, MySurface->format->Bmask, MySurface->format->Amask);
+
+	if (Copy == 0)
+		return false;
+
+	Flags = MySurface->flags & SDL_SRCALPHA;
+	Alpha = MySurface->format->alpha;
+
+	SDL_SetAlpha(MySurface, 0, Alpha);
+	SDL_BlitSurface(MySurface, &Part, Copy, 0);
+	SDL_SetAlpha(MySurface, Flags, Alpha);
+
+	ImageCache::Release(MySurface);
+	MySurface = Copy;
+	Shared = false;
+
+	return true;
+}
+
+void			Surface::Release		(void)
+{
+	if (Shared)
+		ImageCache::Release(MySurface);
+	else if (MySurface != 0)
+		SDL_FreeSurface(MySurface);
+
+	MySurface = 0;
+	Shared = false;
+}
+
 }
@@ -50,6 +50,8 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #include <SDL_ttf.h>
 #include <cmath>
 #include <fstream>
+#include "CardAtlas.h"
+#include "Compositor.h"
 #include "Dimensions.h"
 
 namespace _SDLMille
@@ -82,23 +84,29 @@ public:
 			void			SetImage		(const char * File);
 			void			SetInteger		(int Value, TTF_Font * Font, bool ShowZero = true, SDL_Color *fgColor = 0, SDL_Color *bgColor = 0);
 			//void			SetRGBALoss		(Uint8 R, Uint8 G, Uint8 B, Uint8 A);
+			void			SetSprite		(Uint8 Sprite);
 			void			SetText			(const char * Text, TTF_Font * Font, SDL_Color *fgColor = 0, SDL_Color *bgColor = 0);
 			void			SetX			(int XCoord);
 			void			SetY			(int YCoord);
 							operator bool	(void)																			const;
 
-	static	bool			Draw			(SDL_Surface * Destination, SDL_Surface * Source, int X, int Y, int ScaleMode = SCALE_X_Y, bool Free = false);
+	static	bool			Draw			(SDL_Surface * Destination, SDL_Surface * Source, int X, int Y, int ScaleMode = SCALE_X_Y, bool Free = false, const SDL_Rect *Part = 0);
 	static	SDL_Surface *	Load			(const char * File);
 	static	SDL_Surface *	RenderText		(const char * Text, TTF_Font *Font, SDL_Color *fgColor = 0, SDL_Color *bgColor = 0);
 private:
 			bool			CheckCache		(const char * Text);
+			bool			Own				(void);
+			void			Release			(void);
 
 	SDL_Surface		*MySurface;
+	SDL_Rect		Part;		// The part of a shared MySurface this surface shows
 	char			*Cached;
-	int				Integer,
+	int				Integer,	// The value shown by SetInteger, or the sprite shown by SetSprite
 					Length,
 					X,
 					Y;
+	Uint32			Stamp;		// Changes with the image, so the Compositor can tell redraws apart
+	bool			Shared;		// MySurface belongs to the card atlas or the image cache, so is never freed here
 };
 
 inline	int				Surface::GetX			(void)	const
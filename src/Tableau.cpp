@@ -22,17 +22,8 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 namespace _SDLMille
 {
 
-Surface		Tableau::MileageSurfaces[MILEAGE_PILES],
-			Tableau::ShadowSurface,
-			Tableau::ShadowSurfaceCF;
-TTF_Font	*Tableau::MyFont;
-Uint32		Tableau::LastAnimationBlit;
-bool		Tableau::EnableAnimation;
-
 		Tableau::Tableau		(void)
 {
-	MyFont = 0;
-
 	for (int i = 0; i < MILEAGE_PILES; ++i)
 		CardCount[i] = 0;
 
@@ -44,143 +35,11 @@ bool		Tableau::EnableAnimation;
 	
 	//Animating = false;
 	Dirty = true;
-	EnableAnimation = true;
 	Mileage = 0;
 	OldTopCard = TopCard = CARD_NULL_NULL;
 	OldLimitCard = LimitCard = CARD_NULL_NULL;
-}
 
-		Tableau::~Tableau		(void)
-{
-	if (MyFont != 0)
-	{
-		TTF_CloseFont(MyFont);
-		MyFont = 0;
-	}
-}
-
-/*
-void	Tableau::Animate		(Uint8 PlayerIndex, SDL_Surface *Target)
-{
-	return;
-	EnableAnimation = false;
-
-	static	bool	BattleArea = false,
-					LimitArea = false;
-
-	static	Surface	RollCard,
-					EndLimit;
-
-			int		AreaTop = 1;
-
-	static	int		i = 0;
-	static	int		SafetyX,
-					SafetyY,
-					RollX,
-					RollY,
-					EndLimitX,
-					EndLimitY;
-
-	#ifdef	SOFTWARE_MODE
-			int		Divisor = 35;
-	#else
-			int		Divisor = 70;
-	#endif
-
-	if (PlayerIndex == 0)
-		AreaTop += Dimensions::TableauHeight;
-
-	if (!Animating)
-	{
-		Animating = true;
-		i = 0;
-		LastAnimationBlit = 0;
-
-		if (IsRolling() && HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && (TopCard != CARD_REMEDY_ROLL))
-			BattleArea = true;
-		if (LimitCard == CARD_HAZARD_SPEED_LIMIT)
-			LimitArea = true;
-
-		RollCard.SetImage("gfx/remedy_roll.png");
-		EndLimit.SetImage("gfx/remedy_end_limit.png");
-
-		SafetyX = (Dimensions::MultiRowSafeties) ? 213 : 271;
-		SafetyY = (Dimensions::MultiRowSafeties) ? 117 : 76;
-		if (PlayerIndex == 0)
-			SafetyY += Dimensions::TableauHeight;
-
-		EndLimitX = RollX = SafetyX;
-		EndLimitY = RollY = SafetyY;
-	}
-	else
-	{
-		if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (TopCard != CARD_HAZARD_STOP))
-		{
-			BattleArea = false;
-			RollX = BattleX;
-		}
-	}
-
-	if (!EnableAnimation)
-		RollY = AreaTop - 1;
-
-	if (RollY >= AreaTop)
-	{
-		int	Y = 1;
-
-		if (PlayerIndex == 0)
-			Y += Dimensions::TableauHeight;
-
-		if (BattleArea)
-			RollCard.Render(RollX, RollY, Target);
-		if (LimitArea)
-			EndLimit.Render(EndLimitX, EndLimitY, Target);
-
-		if ((LastAnimationBlit + 15) <= SDL_GetTicks())
-		{
-			LastAnimationBlit = SDL_GetTicks();
-			RollX = SafetyX - (((SafetyX - BattleX) * i) / Divisor);
-			RollY = SafetyY - (((SafetyY - AreaTop) * i) / Divisor);
-			EndLimitX = SafetyX - (((SafetyX - LimitX) * i) / Divisor);
-			EndLimitY = RollY;
-
-			++i;
-		}
-	}
-	else
-	{
-		if (BattleArea)
-		{
-			BattleArea = false;
-			SetTopCard(CARD_REMEDY_ROLL);
-			RollCard.Render(BattleX, AreaTop, Target);
-		}
-		if (LimitArea)
-		{
-			LimitArea = false;
-			LimitCard = CARD_REMEDY_END_LIMIT;
-			EndLimit.Render(LimitX, AreaTop, Target);
-		}
-
-
-		Animating = false;
-	}
-
-	Dirty = true;
-}
-*/
-
-void		Tableau::BlitWithShadow	(Surface &CardSurface, int X, int Y, SDL_Surface *Target, bool CoupFourre)
-{
-	if (CardSurface)
-	{
-		if (CoupFourre)
-			ShadowSurfaceCF.Render(X, Y, Target);
-		else
-			ShadowSurface.Render(X, Y, Target);
-
-		CardSurface.Render(X, Y, Target);
-	}
+	Rehash();
 }
 
 Uint8	Tableau::GetPileCount		(Uint8 Value)														const
@@ -191,60 +50,6 @@ Uint8	Tableau::GetPileCount		(Uint8 Value)														const
 	return 0;
 }
 
-void	Tableau::GetTargetCoords	(Uint8 Value, Uint8 PlayerIndex, int &X, int &Y, bool CoupFourre, Uint8 PileCount)
-{
-	Uint8 Type = Card::GetTypeFromValue(Value);
-
-	if (Type < CARD_NULL)
-	{
-		//Y = 1;
-		Y = Dimensions::TableauSpacingY;
-
-		if (PlayerIndex == 0)
-			Y += Dimensions::TableauHeight;
-
-		if ((Type == CARD_HAZARD) || (Type == CARD_REMEDY))
-		{
-			if ((Value == CARD_HAZARD_SPEED_LIMIT) || (Value == CARD_REMEDY_END_LIMIT))
-				X = Dimensions::TableauLimitX;
-			else
-				X = Dimensions::TableauBattleX;
-		}
-		else if (Type == CARD_MILEAGE)
-		{
-			X = (Value - MILEAGE_OFFSET) * 42 + 2;
-			if (PileCount > 0)
-				Y += PileCount * 8;
-		}
-		else if (Type == CARD_SAFETY)
-		{
-			int	SafetyYIncrement = Dimensions::GamePlayCardHeight + Dimensions::TableauSpacingY,
-				SafetyXIncrement = Dimensions::GamePlayCardWidth + Dimensions::TableauSpacingX;
-
-			if (Dimensions::MultiRowSafeties)
-			{
-				X = Dimensions::TableauBattleX;
-				Y += SafetyYIncrement;
-				if ((Value - SAFETY_OFFSET) > 1)
-					Y += SafetyYIncrement;
-				if ((Value - SAFETY_OFFSET) % 2 == 0)
-					X = Dimensions::TableauLimitX;
-			}
-			else
-			{
-				Y += SafetyYIncrement;
-				X = Dimensions::TableauLimitX - ((SAFETY_COUNT - (Value - SAFETY_OFFSET)) * SafetyXIncrement);
-			}
-
-			if (CoupFourre)
-			{
-				Y += 8;
-				X -= 8;
-			}
-		}
-	}
-}
-
 Uint8	Tableau::GetTopCard		(bool SpeedPile)								const
 {
 	if (SpeedPile)
@@ -297,51 +102,6 @@ bool	Tableau::IsRolling		(void)											const
 	return false;
 }
 
-void	Tableau::OnInit			(void)
-{
-	if (MyFont == 0)
-	{
-		// Set up font
-		if (!TTF_WasInit())
-			TTF_Init();
-
-		MyFont = TTF_OpenFont("LiberationMono-Regular.ttf", 24);
-	}
-
-	// Refresh our surfaces
-	Backdrop.SetImage("gfx/overlays/tableau.png");
-	BattleSurface.SetImage(Card::GetFileFromValue(TopCard));
-	LimitSurface.SetImage(Card::GetFileFromValue(LimitCard));
-
-	ShadowSurface.SetImage("gfx/card_shadow.png");
-	ShadowSurfaceCF.SetImage("gfx/card_shadow_cf.png");
-
-	if (IsRolling())
-	{
-		if (HasSpeedLimit())
-			Backdrop.SetImage("gfx/overlays/tableau_yellow.png");
-		else
-			Backdrop.SetImage("gfx/overlays/tableau_green.png");
-	}
-	else
-		Backdrop.SetImage("gfx/overlays/tableau_red.png");
-
-	for (int i = 0; i < MILEAGE_PILES; ++i)
-		MileageSurfaces[i].SetImage(Card::GetFileFromValue(i + MILEAGE_OFFSET));
-
-	for (int i = 0; i < SAFETY_COUNT; ++i)
-	{
-		if (Safeties[i])
-		{
-			if (!SafetySurfaces[i])
-				SafetySurfaces[i].SetImage(Card::GetFileFromValue(i + SAFETY_OFFSET, CoupFourres[i]));
-		}
-	}
-
-	if ((Mileage <= 1000) && MyFont)
-		MileageTextSurface.SetInteger(Mileage, MyFont);	// Font is valid, mileage is sane
-}
-
 void	Tableau::OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit)
 {
 	Uint8	Type =	Card::GetTypeFromValue(Value),
@@ -357,7 +117,9 @@ void	Tableau::OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit)
 		{
 			if (CardCount[Index] < MAX_CARD_COUNT[Index])
 			{
+				Hash ^= GetZobristKey(ZOBRIST_PILE + Index * ZOBRIST_BLOCK + CardCount[Index]);
 				++CardCount[Index];
+				Hash ^= GetZobristKey(ZOBRIST_PILE + Index * ZOBRIST_BLOCK + CardCount[Index]);
 				Mileage += Card::GetMileValue(Value);
 			}
 			else
@@ -369,8 +131,8 @@ void	Tableau::OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit)
 		{
 			if (!HasSpeedLimit())
 			{
-				OldLimitCard = LimitCard;
-				LimitCard = Value;
+				Replace(OldLimitCard, ZOBRIST_OLD_LIMIT_CARD, LimitCard);
+				Replace(LimitCard, ZOBRIST_LIMIT_CARD, Value);
 			}
 		}
 		else
@@ -383,7 +145,7 @@ void	Tableau::OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit)
 		if (Value == CARD_REMEDY_END_LIMIT)
 		{
 			if (HasSpeedLimit())
-				LimitCard = Value;
+				Replace(LimitCard, ZOBRIST_LIMIT_CARD, Value);
 		}
 		else if (Value == CARD_REMEDY_ROLL)
 		{
@@ -400,128 +162,47 @@ void	Tableau::OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit)
 		Index = Value - SAFETY_OFFSET;
 		if (Index < SAFETY_COUNT)
 		{
+			if (!Safeties[Index])
+				Hash ^= GetZobristKey(ZOBRIST_SAFETY + Index);
 			Safeties[Index] = true;
 
 			if (CoupFourre)
 			{
+				if (!CoupFourres[Index])
+					Hash ^= GetZobristKey(ZOBRIST_COUP_FOURRE + Index);
 				CoupFourres[Index] = true;
 
 				// Throw away the hazard
 				if (SpeedLimit)
-					LimitCard = OldLimitCard;
+					Replace(LimitCard, ZOBRIST_LIMIT_CARD, OldLimitCard);
 				else
-					TopCard = OldTopCard;
+					Replace(TopCard, ZOBRIST_TOP_CARD, OldTopCard);
 			}
 		}
 		break;
 	}
 }
 
-bool	Tableau::OnRender		(SDL_Surface * Target, Uint8 PlayerIndex, bool Force)
+void	Tableau::Pack			(TableauState &State)							const
 {
-			SDL_Rect	PlayerRect =	{0, 0, Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight};
-	//static	bool		RectSetUp =		false;
-	//static	Uint8		LastStatus =	0xFF;
-			bool		WasDirty =		Dirty;
+	State.Piles[MILEAGE_PILES / 2] = 0;
 
-	//if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (TopCard != CARD_HAZARD_STOP) && HasSafety(Card::GetMatchingSafety(TopCard)))
-	//	SetTopCard(TopCard + 5);
-
-	if (Target != 0)
-	{
-		if (Dirty || Force)
-		{
-			if (Dirty)
-			{
-				OnInit();
-				Dirty = false;
-			}
-
-			int	R, G = 0, B = 0,
-				X = 0, Y = Dimensions::TableauSpacingY, SafetyY = 0, TopY = 0;
-
-			if (PlayerIndex == 0)
-			{
-				Y += Dimensions::TableauHeight;
-				PlayerRect.y += Dimensions::EffectiveTableauHeight;
-				TopY += Dimensions::TableauHeight;
-			}
-			
-			///* Color-coding */
-			Uint8	Status = STATUS_STOPPED;
-
-			if (IsRolling())
-			{
-				if (HasSpeedLimit())
-					Status = STATUS_LIMITED;
-				else
-					Status = STATUS_ROLLING;
-			}
-
-			//if (Status != LastStatus)
-			//{
-				switch(Status)
-				{
-				case	STATUS_ROLLING:
-					R = 20; G = 153; B = 23; break;
-				case	STATUS_LIMITED:
-					R = 180; G = 165; B = 1; break;
-				default:
-					R = 164; B = 1;
-				}
-
-			//	Backdrop.SetRGBALoss(0, 255, 255, 0);
-
-				SDL_FillRect(Target, &PlayerRect, SDL_MapRGB(Target->format, R, G, B));
-
-				if (Status == STATUS_LIMITED)
-					Backdrop.SetX(Dimensions::TableauLimitX + (Dimensions::GamePlayCardWidth >> 1) - (Backdrop.GetWidth() >> 1));
-				else
-					Backdrop.SetX(Dimensions::TableauBattleX + (Dimensions::GamePlayCardWidth >> 1) - (Backdrop.GetWidth() >> 1));
-
-				Backdrop.SetY(Y - Dimensions::TableauSpacingY);
-			//}
-
-			Backdrop.Render(Target);
-
-			// Draw our stuff
-			for (int i = 0; i < MILEAGE_PILES; ++i)
-			{
-				if (CardCount[i])
-				{
-					for (int j = 0; j < CardCount[i]; ++j)
-						BlitWithShadow(MileageSurfaces[i], (i * (Dimensions::GamePlayCardWidth + Dimensions::TableauSpacingX)) + Dimensions::TableauSpacingX, Y + (j * 8), Target);
-				}
-				//for (int j = 0; j < MAX_PILE_SIZE; ++ j)
-				//	BlitWithShadow(PileSurfaces[i][j], (i * 42) + 2, Y + (j * 8), Target);
-			}
-
-			BlitWithShadow(BattleSurface, Dimensions::TableauBattleX, Y, Target);
-
-			BlitWithShadow(LimitSurface, Dimensions::TableauLimitX, Y, Target);
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+		SetNibble(State.Piles, i, CardCount[i]);
 
-			for (int i = 0; i < SAFETY_COUNT; ++i)
-			{
-				if (SafetySurfaces[i])
-				{
-					bool CoupFourre = CoupFourres[i];
-					GetTargetCoords(i + SAFETY_OFFSET, PlayerIndex, X, SafetyY, CoupFourre);
-					BlitWithShadow(SafetySurfaces[i], X, SafetyY, Target, CoupFourre);
-				}
-			}
+	State.LimitCard = LimitCard;
+	State.OldLimitCard = OldLimitCard;
+	State.TopCard = TopCard;
+	State.OldTopCard = OldTopCard;
+	State.Safeties = 0;
 
-			MileageTextSurface.Render(65 - MileageTextSurface.GetWidth(), TopY + Dimensions::TableauHeight - MileageTextSurface.GetHeight() - 5, Target);
-		}
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (Safeties[i])
+			State.Safeties |= 1 << i;
+		if (CoupFourres[i])
+			State.Safeties |= 1 << (i + SAFETY_COUNT);
 	}
-
-	//if (Animating)
-	//	Animate(PlayerIndex, Target);
-	//else if (IsRolling() && HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && (TopCard != CARD_REMEDY_ROLL))
-	//	Animate(PlayerIndex, Target);
-	//else if ((LimitCard == CARD_HAZARD_SPEED_LIMIT) && (HasSafety(CARD_SAFETY_RIGHT_OF_WAY)))
-	//	Animate(PlayerIndex, Target);
-
-	return WasDirty;
 }
 
 void	Tableau::Reset			(void)
@@ -530,10 +211,7 @@ void	Tableau::Reset			(void)
 		CardCount[i] = 0;
 
 	for (int i = 0; i < SAFETY_COUNT; ++i)
-	{
-		SafetySurfaces[i].Clear();
 		CoupFourres[i] = Safeties[i] = false;
-	}
 
 	OldLimitCard = LimitCard = OldTopCard = TopCard = CARD_NULL_NULL;
 
@@ -541,6 +219,7 @@ void	Tableau::Reset			(void)
 
 	//Animating = false;
 
+	Rehash();
 	Dirty = true;
 }
 
@@ -559,6 +238,7 @@ bool	Tableau::Restore		(FILE *SaveFile)
 
 		fread(&Mileage, sizeof(Uint32), 1, SaveFile);
 
+		Rehash();
 		return true;
 	}
 
@@ -586,26 +266,76 @@ bool	Tableau::Save			(FILE *SaveFile)
 	return false;
 }
 
+void	Tableau::UnPack			(const TableauState &State)
+{
+	// Mileage isn't stored; it follows from the piles
+	Mileage = 0;
+
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+	{
+		CardCount[i] = GetNibble(State.Piles, i);
+		Mileage += CardCount[i] * Card::GetMileValue(i + MILEAGE_OFFSET);
+	}
+
+	LimitCard = State.LimitCard;
+	OldLimitCard = State.OldLimitCard;
+	TopCard = State.TopCard;
+	OldTopCard = State.OldTopCard;
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		Safeties[i] = (State.Safeties & (1 << i)) != 0;
+		CoupFourres[i] = (State.Safeties & (1 << (i + SAFETY_COUNT))) != 0;
+	}
+
+	Rehash();
+	Dirty = true;
+}
+
 void	Tableau::UpdateTopCard	(bool IncludeRollCard, bool IncludeEndLimit)
 {
 	Dirty = true;
 
 	if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (HasSafety(Card::GetMatchingSafety(TopCard))) && (TopCard != CARD_HAZARD_STOP))
-		TopCard += 5;
+		Replace(TopCard, ZOBRIST_TOP_CARD, TopCard + 5);
 
 	if (IncludeRollCard && IsRolling() && (TopCard != CARD_REMEDY_ROLL))
-		TopCard = CARD_REMEDY_ROLL;
+		Replace(TopCard, ZOBRIST_TOP_CARD, CARD_REMEDY_ROLL);
 
 	if (IncludeEndLimit && (LimitCard == CARD_HAZARD_SPEED_LIMIT) && HasSafety(CARD_SAFETY_RIGHT_OF_WAY))
-		LimitCard = CARD_REMEDY_END_LIMIT;
+		Replace(LimitCard, ZOBRIST_LIMIT_CARD, CARD_REMEDY_END_LIMIT);
 }
 
 /* Private Methods */
 
+void	Tableau::Rehash			(void)
+{
+	Hash = GetZobristCardKey(ZOBRIST_TOP_CARD, TopCard) ^ GetZobristCardKey(ZOBRIST_OLD_TOP_CARD, OldTopCard)
+		^ GetZobristCardKey(ZOBRIST_LIMIT_CARD, LimitCard) ^ GetZobristCardKey(ZOBRIST_OLD_LIMIT_CARD, OldLimitCard);
+
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+		Hash ^= GetZobristKey(ZOBRIST_PILE + i * ZOBRIST_BLOCK + CardCount[i]);
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (Safeties[i])
+			Hash ^= GetZobristKey(ZOBRIST_SAFETY + i);
+		if (CoupFourres[i])
+			Hash ^= GetZobristKey(ZOBRIST_COUP_FOURRE + i);
+	}
+}
+
+void	Tableau::Replace		(Uint8 &Field, Uint32 KeyOffset, Uint8 Value)
+{
+	// Every card field goes through here so the hash stays in step
+	Hash ^= GetZobristCardKey(KeyOffset, Field) ^ GetZobristCardKey(KeyOffset, Value);
+	Field = Value;
+}
+
 void	Tableau::SetTopCard		(Uint8 Value)
 {
-	OldTopCard = TopCard;
-	TopCard = Value;
+	Replace(OldTopCard, ZOBRIST_OLD_TOP_CARD, TopCard);
+	Replace(TopCard, ZOBRIST_TOP_CARD, Value);
 }
 
 }
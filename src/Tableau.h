@@ -21,6 +21,7 @@ along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
 #define	_SDLMILLE_TABLEAU_H
 
 #include "Card.h"
+#include "Zobrist.h"
 
 namespace _SDLMille
 {
@@ -33,52 +34,48 @@ const Uint8	SAFETY_COUNT = 4,
 				exception of 100's and 200's. Each player is limited to playing a maximum of two 200-mile cards.
 				There are 12 cards with a value of 100, but it is impossible to play more than 10 (1,000 miles) */
 
-const int	BattleX = 220,
-			LimitX = 265,
-			TABLEAU_TOO_MANY_CARDS = 5000;
+const int	TABLEAU_TOO_MANY_CARDS = 5000;
 
-enum		{STATUS_ROLLING, STATUS_LIMITED, STATUS_STOPPED};
+/*	A tableau packed into 9 bytes for GameState. Pile counts are stored two per byte, and
+	Safeties holds one bit per safety in the low nibble and one per Coup Fourre in the high. */
+
+struct TableauState
+{
+	Uint8	Piles[(MILEAGE_PILES + 1) / 2],
+			LimitCard, OldLimitCard,
+			TopCard, OldTopCard,
+			Safeties;
+};
 
 class Tableau
 {
 public:
 				Tableau			(void);
-				~Tableau		(void);
-	//void		Animate			(Uint8 PlayerIndex, SDL_Surface *Target);
-	//bool		AnimationRunning	(void)														const;
-	void		BlitWithShadow	(Surface &CardSurface, int X, int Y, SDL_Surface *Target, bool CoupFourre = false);
+				~Tableau		(void)															{}
+	void		ClearDirty		(void);
+	Uint64		GetHash			(void)															const;
 	int			GetMileage		(void)															const;
 	Uint8		GetPileCount	(Uint8 Value)													const;
-	static	void	GetTargetCoords	(Uint8 Value, Uint8 PlayerIndex, int &X, int &Y, bool CoupFourre, Uint8 PileCount = 0);
 	Uint8		GetTopCard		(bool SpeedPile = false)										const;
 	bool		HasCoupFourre	(Uint8 Value)													const;
 	bool		HasSafety		(Uint8 Value)													const;
 	bool		HasSpeedLimit	(void)															const;
 	bool		IsDirty			(void)															const;
 	bool		IsRolling		(void)															const;
-	void		OnInit			(void);
-	bool		OnRender		(SDL_Surface * Target, Uint8 PlayerIndex, bool Force = false);
 	void		OnPlay			(Uint8 Value, bool CoupFourre, bool SpeedLimit);
+	void		Pack			(TableauState &State)											const;
 	void		Reset			(void);
 	bool		Restore			(FILE *SaveFile);
 	bool		Save			(FILE *SaveFile);
+	void		UnPack			(const TableauState &State);
 	void		UpdateTopCard	(bool IncludeRollCard, bool IncludeEndLimit);
-
-static	Surface	ShadowSurface,
-				ShadowSurfaceCF;
-static	Uint32	LastAnimationBlit;
-static	bool	EnableAnimation;
 private:
 	/* Methods */
+	void		Rehash			(void);
+	void		Replace			(Uint8 &Field, Uint32 KeyOffset, Uint8 Value);
 	void		SetTopCard		(Uint8 Value);
 
 	/* Properties */
-	Surface		Backdrop,
-				BattleSurface,
-				LimitSurface,
-				MileageTextSurface,
-				SafetySurfaces[SAFETY_COUNT];
-static	Surface	MileageSurfaces[MILEAGE_PILES];
 	Uint8		CardCount[MILEAGE_PILES],
 				LimitCard, OldLimitCard,
 				TopCard, OldTopCard;
@@ -87,13 +84,18 @@ static	Surface	MileageSurfaces[MILEAGE_PILES];
 				Dirty,
 				Safeties[SAFETY_COUNT];
 	Uint32		Mileage;
-static	TTF_Font	*MyFont;
+	Uint64		Hash;	// XOR of the Zobrist keys of the piles, cards and safeties
 };
 
-//inline	bool	Tableau::AnimationRunning	(void)	const
-//{
-//	return Animating;
-//}
+inline	void	Tableau::ClearDirty			(void)
+{
+	Dirty = false;
+}
+
+inline	Uint64	Tableau::GetHash			(void)	const
+{
+	return Hash;
+}
 
 inline	int		Tableau::GetMileage			(void)	const
 {
@@ -0,0 +1,429 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "TableauView.h"
+#include "GlyphAtlas.h"
+#include <string.h>
+
+namespace _SDLMille
+{
+
+Surface		TableauView::MileageSurfaces[MILEAGE_PILES],
+			TableauView::ShadowSurface,
+			TableauView::ShadowSurfaceCF;
+TTF_Font	*TableauView::MyFont;
+Uint32		TableauView::LastAnimationBlit;
+bool		TableauView::EnableAnimation = true;
+
+		TableauView::~TableauView	(void)
+{
+	if (Layer != 0)
+	{
+		SDL_FreeSurface(Layer);
+		Layer = 0;
+	}
+
+	if (MyFont != 0)
+	{
+		GlyphAtlas::Forget(MyFont);
+		TTF_CloseFont(MyFont);
+		MyFont = 0;
+	}
+}
+
+/*
+void	TableauView::Animate		(Uint8 PlayerIndex, SDL_Surface *Target)
+{
+	return;
+	EnableAnimation = false;
+
+	static	bool	BattleArea = false,
+					LimitArea = false;
+
+	static	Surface	RollCard,
+					EndLimit;
+
+			int		AreaTop = 1;
+
+	static	int		i = 0;
+	static	int		SafetyX,
+					SafetyY,
+					RollX,
+					RollY,
+					EndLimitX,
+					EndLimitY;
+
+	#ifdef	SOFTWARE_MODE
+			int		Divisor = 35;
+	#else
+			int		Divisor = 70;
+	#endif
+
+	if (PlayerIndex == 0)
+		AreaTop += Dimensions::TableauHeight;
+
+	if (!Animating)
+	{
+		Animating = true;
+		i = 0;
+		LastAnimationBlit = 0;
+
+		if (IsRolling() && HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && (TopCard != CARD_REMEDY_ROLL))
+			BattleArea = true;
+		if (LimitCard == CARD_HAZARD_SPEED_LIMIT)
+			LimitArea = true;
+
+		RollCard.SetImage("gfx/remedy_roll.png");
+		EndLimit.SetImage("gfx/remedy_end_limit.png");
+
+		SafetyX = (Dimensions::MultiRowSafeties) ? 213 : 271;
+		SafetyY = (Dimensions::MultiRowSafeties) ? 117 : 76;
+		if (PlayerIndex == 0)
+			SafetyY += Dimensions::TableauHeight;
+
+		EndLimitX = RollX = SafetyX;
+		EndLimitY = RollY = SafetyY;
+	}
+	else
+	{
+		if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (TopCard != CARD_HAZARD_STOP))
+		{
+			BattleArea = false;
+			RollX = BattleX;
+		}
+	}
+
+	if (!EnableAnimation)
+		RollY = AreaTop - 1;
+
+	if (RollY >= AreaTop)
+	{
+		int	Y = 1;
+
+		if (PlayerIndex == 0)
+			Y += Dimensions::TableauHeight;
+
+		if (BattleArea)
+			RollCard.Render(RollX, RollY, Target);
+		if (LimitArea)
+			EndLimit.Render(EndLimitX, EndLimitY, Target);
+
+		if ((LastAnimationBlit + 15) <= SDL_GetTicks())
+		{
+			LastAnimationBlit = SDL_GetTicks();
+			RollX = SafetyX - (((SafetyX - BattleX) * i) / Divisor);
+			RollY = SafetyY - (((SafetyY - AreaTop) * i) / Divisor);
+			EndLimitX = SafetyX - (((SafetyX - LimitX) * i) / Divisor);
+			EndLimitY = RollY;
+
+			++i;
+		}
+	}
+	else
+	{
+		if (BattleArea)
+		{
+			BattleArea = false;
+			SetTopCard(CARD_REMEDY_ROLL);
+			RollCard.Render(BattleX, AreaTop, Target);
+		}
+		if (LimitArea)
+		{
+			LimitArea = false;
+			LimitCard = CARD_REMEDY_END_LIMIT;
+			EndLimit.Render(LimitX, AreaTop, Target);
+		}
+
+
+		Animating = false;
+	}
+
+	Dirty = true;
+}
+*/
+
+void	TableauView::BlitWithShadow	(Surface &CardSurface, int X, int Y, SDL_Surface *Target, bool CoupFourre)
+{
+	if (CardSurface)
+	{
+		if (CoupFourre)
+			ShadowSurfaceCF.Render(X, Y, Target);
+		else
+			ShadowSurface.Render(X, Y, Target);
+
+		CardSurface.Render(X, Y, Target);
+	}
+}
+
+void	TableauView::GetTargetCoords	(Uint8 Value, Uint8 PlayerIndex, int &X, int &Y, bool CoupFourre, Uint8 PileCount)
+{
+	Uint8 Type = Card::GetTypeFromValue(Value);
+
+	if (Type < CARD_NULL)
+	{
+		//Y = 1;
+		Y = Dimensions::TableauSpacingY;
+
+		if (PlayerIndex == 0)
+			Y += Dimensions::TableauHeight;
+
+		if ((Type == CARD_HAZARD) || (Type == CARD_REMEDY))
+		{
+			if ((Value == CARD_HAZARD_SPEED_LIMIT) || (Value == CARD_REMEDY_END_LIMIT))
+				X = Dimensions::TableauLimitX;
+			else
+				X = Dimensions::TableauBattleX;
+		}
+		else if (Type == CARD_MILEAGE)
+		{
+			X = (Value - MILEAGE_OFFSET) * 42 + 2;
+			if (PileCount > 0)
+				Y += PileCount * 8;
+		}
+		else if (Type == CARD_SAFETY)
+		{
+			int	SafetyYIncrement = Dimensions::GamePlayCardHeight + Dimensions::TableauSpacingY,
+				SafetyXIncrement = Dimensions::GamePlayCardWidth + Dimensions::TableauSpacingX;
+
+			if (Dimensions::MultiRowSafeties)
+			{
+				X = Dimensions::TableauBattleX;
+				Y += SafetyYIncrement;
+				if ((Value - SAFETY_OFFSET) > 1)
+					Y += SafetyYIncrement;
+				if ((Value - SAFETY_OFFSET) % 2 == 0)
+					X = Dimensions::TableauLimitX;
+			}
+			else
+			{
+				Y += SafetyYIncrement;
+				X = Dimensions::TableauLimitX - ((SAFETY_COUNT - (Value - SAFETY_OFFSET)) * SafetyXIncrement);
+			}
+
+			if (CoupFourre)
+			{
+				Y += 8;
+				X -= 8;
+			}
+		}
+	}
+}
+
+void	TableauView::OnInit		(const Tableau &Model)
+{
+	if (MyFont == 0)
+	{
+		// Set up font
+		if (!TTF_WasInit())
+			TTF_Init();
+
+		MyFont = TTF_OpenFont("LiberationMono-Regular.ttf", 24);
+	}
+
+	// Refresh our surfaces
+	Backdrop.SetImage("gfx/overlays/tableau.png");
+	BattleSurface.SetSprite(Model.GetTopCard());
+	LimitSurface.SetSprite(Model.GetTopCard(true));
+
+	ShadowSurface.SetSprite(CARD_SPRITE_SHADOW);
+	ShadowSurfaceCF.SetSprite(CARD_SPRITE_SHADOW_CF);
+
+	if (Model.IsRolling())
+	{
+		if (Model.HasSpeedLimit())
+			Backdrop.SetImage("gfx/overlays/tableau_yellow.png");
+		else
+			Backdrop.SetImage("gfx/overlays/tableau_green.png");
+	}
+	else
+		Backdrop.SetImage("gfx/overlays/tableau_red.png");
+
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+		MileageSurfaces[i].SetSprite(i + MILEAGE_OFFSET);
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (Model.HasSafety(i + SAFETY_OFFSET))
+		{
+			if (!SafetySurfaces[i])
+				SafetySurfaces[i].SetSprite(CardAtlas::GetSprite(i + SAFETY_OFFSET, Model.HasCoupFourre(i + SAFETY_OFFSET)));
+		}
+		else
+			SafetySurfaces[i].Clear();	// Tableau was reset
+	}
+
+	if ((Model.GetMileage() <= 1000) && MyFont)
+		MileageTextSurface.SetInteger(Model.GetMileage(), MyFont);	// Font is valid, mileage is sane
+}
+
+bool	TableauView::OnRender		(SDL_Surface * Target, Tableau &Model, Uint8 PlayerIndex, bool Force)
+{
+			SDL_Rect	PlayerRect =	{0, 0, Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight};
+			bool		WasDirty =		Model.IsDirty();
+
+	//if ((Card::GetTypeFromValue(TopCard) == CARD_HAZARD) && (TopCard != CARD_HAZARD_STOP) && HasSafety(Card::GetMatchingSafety(TopCard)))
+	//	SetTopCard(TopCard + 5);
+
+	if (Target != 0)
+	{
+		if (WasDirty || Force)
+		{
+			if (WasDirty)
+			{
+				OnInit(Model);
+				Model.ClearDirty();
+			}
+
+			if (PlayerIndex == 0)
+				PlayerRect.y += Dimensions::EffectiveTableauHeight;
+
+			// Recomposite only if something changed; without a layer, draw straight to the target
+			if (CheckLayer(Target) || WasDirty)
+			{
+				if (Layer != 0)
+				{
+					Draw(Layer, Model, PlayerIndex, PlayerRect.y);
+					LayerStamp = Compositor::NewStamp();
+				}
+				else
+					Draw(Target, Model, PlayerIndex, 0);
+			}
+
+			if ((Layer != 0) && !Compositor::Record(Target, Layer, LayerStamp, 0, PlayerRect.x, PlayerRect.y))
+				SDL_BlitSurface(Layer, 0, Target, &PlayerRect);
+		}
+	}
+
+	//if (Animating)
+	//	Animate(PlayerIndex, Target);
+	//else if (IsRolling() && HasSafety(CARD_SAFETY_RIGHT_OF_WAY) && (TopCard != CARD_REMEDY_ROLL))
+	//	Animate(PlayerIndex, Target);
+	//else if ((LimitCard == CARD_HAZARD_SPEED_LIMIT) && (HasSafety(CARD_SAFETY_RIGHT_OF_WAY)))
+	//	Animate(PlayerIndex, Target);
+
+	return WasDirty;
+}
+
+/* Private methods */
+
+bool	TableauView::CheckLayer		(SDL_Surface *Target)
+{
+	int	Layout[TABLEAU_LAYOUT_VALUES] = {	Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight, Dimensions::TableauHeight,
+											Dimensions::TableauSpacingX, Dimensions::TableauSpacingY, Dimensions::GamePlayCardWidth,
+											Dimensions::GamePlayCardHeight, Dimensions::TableauBattleX, Dimensions::TableauLimitX,
+											Dimensions::MultiRowSafeties, Target->format->BitsPerPixel	};
+
+	// Returns true if the layer has been made afresh and needs drawing
+	if ((Layer != 0) && (memcmp(Layout, LayerLayout, sizeof(Layout)) == 0))
+		return false;
+
+	memcpy(LayerLayout, Layout, sizeof(Layout));
+
+	if (Layer != 0)
+		SDL_FreeSurface(Layer);
+
+	#ifdef	SOFTWARE_MODE
+	Layer = SDL_CreateRGBSurface(SDL_SWSURFACE, Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight, Target->format->BitsPerPixel,
+								 Target->format->Rmask, Target->format->Gmask, Target->format->Bmask, 0);
+	#else
+	Layer = SDL_CreateRGBSurface(SDL_HWSURFACE, Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight, Target->format->BitsPerPixel,
+								 Target->format->Rmask, Target->format->Gmask, Target->format->Bmask, 0);
+	#endif
+
+	return true;
+}
+
+void	TableauView::Draw			(SDL_Surface *Destination, Tableau &Model, Uint8 PlayerIndex, int Top)
+{
+	/*	Everything is placed as it would be on the screen, then moved up by Top, which is
+		where the tableau starts when Destination is its layer. */
+	SDL_Rect	PlayerRect =	{0, 0, Dimensions::GamePlayTableauWidth, Dimensions::EffectiveTableauHeight};
+	int			R, G = 0, B = 0,
+				X = 0, Y = Dimensions::TableauSpacingY - Top, SafetyY = 0, TopY = -Top;
+
+	if (PlayerIndex == 0)
+	{
+		Y += Dimensions::TableauHeight;
+		PlayerRect.y += Dimensions::EffectiveTableauHeight;
+		TopY += Dimensions::TableauHeight;
+	}
+
+	PlayerRect.y -= Top;
+			
+	///* Color-coding */
+	Uint8	Status = STATUS_STOPPED;
+
+	if (Model.IsRolling())
+	{
+		if (Model.HasSpeedLimit())
+			Status = STATUS_LIMITED;
+		else
+			Status = STATUS_ROLLING;
+	}
+
+	switch(Status)
+	{
+	case	STATUS_ROLLING:
+		R = 20; G = 153; B = 23; break;
+	case	STATUS_LIMITED:
+		R = 180; G = 165; B = 1; break;
+	default:
+		R = 164; B = 1;
+	}
+
+	if (!Compositor::Record(Destination, PlayerRect, SDL_MapRGB(Destination->format, R, G, B)))
+		SDL_FillRect(Destination, &PlayerRect, SDL_MapRGB(Destination->format, R, G, B));
+
+	if (Status == STATUS_LIMITED)
+		Backdrop.SetX(Dimensions::TableauLimitX + (Dimensions::GamePlayCardWidth >> 1) - (Backdrop.GetWidth() >> 1));
+	else
+		Backdrop.SetX(Dimensions::TableauBattleX + (Dimensions::GamePlayCardWidth >> 1) - (Backdrop.GetWidth() >> 1));
+
+	Backdrop.SetY(Y - Dimensions::TableauSpacingY);
+
+	Backdrop.Render(Destination);
+
+	// Draw our stuff
+	for (int i = 0; i < MILEAGE_PILES; ++i)
+	{
+		Uint8	PileCount = Model.GetPileCount(i + MILEAGE_OFFSET);
+
+		for (int j = 0; j < PileCount; ++j)
+			BlitWithShadow(MileageSurfaces[i], (i * (Dimensions::GamePlayCardWidth + Dimensions::TableauSpacingX)) + Dimensions::TableauSpacingX, Y + (j * 8), Destination);
+	}
+
+	BlitWithShadow(BattleSurface, Dimensions::TableauBattleX, Y, Destination);
+
+	BlitWithShadow(LimitSurface, Dimensions::TableauLimitX, Y, Destination);
+
+	for (int i = 0; i < SAFETY_COUNT; ++i)
+	{
+		if (SafetySurfaces[i])
+		{
+			bool CoupFourre = Model.HasCoupFourre(i + SAFETY_OFFSET);
+			GetTargetCoords(i + SAFETY_OFFSET, PlayerIndex, X, SafetyY, CoupFourre);
+			BlitWithShadow(SafetySurfaces[i], X, SafetyY - Top, Destination, CoupFourre);
+		}
+	}
+
+	MileageTextSurface.Render(65 - MileageTextSurface.GetWidth(), TopY + Dimensions::TableauHeight - MileageTextSurface.GetHeight() - 5, Destination);
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_TABLEAUVIEW_H
+#define	_SDLMILLE_TABLEAUVIEW_H
+
+#include "Surface.h"
+#include "Tableau.h"
+
+namespace _SDLMille
+{
+
+const int	BattleX = 220,
+			LimitX = 265;
+
+enum		{STATUS_ROLLING, STATUS_LIMITED, STATUS_STOPPED};
+
+const int	TABLEAU_LAYOUT_VALUES = 11;	// Dimensions a tableau's layer depends on
+
+/*	Renders one player's tableau. The tableau itself is part of the rules engine; the view
+	owns every surface and font, and rebuilds them whenever the model is dirty.
+
+	The cards are composited once into Layer, an opaque surface the size of the tableau, and
+	each frame blits just that. Layer is redrawn only when the model is dirty (a card was
+	played, or the hand was reset or restored) or the layout has changed. */
+
+class TableauView
+{
+public:
+				TableauView		(void)															{Layer = 0; LayerStamp = 0;}
+				~TableauView	(void);
+	//void		Animate			(Uint8 PlayerIndex, SDL_Surface *Target);
+	void		BlitWithShadow	(Surface &CardSurface, int X, int Y, SDL_Surface *Target, bool CoupFourre = false);
+	static	void	GetTargetCoords	(Uint8 Value, Uint8 PlayerIndex, int &X, int &Y, bool CoupFourre, Uint8 PileCount = 0);
+	void		OnInit			(const Tableau &Model);
+	bool		OnRender		(SDL_Surface * Target, Tableau &Model, Uint8 PlayerIndex, bool Force = false);
+
+static	Surface	ShadowSurface,
+				ShadowSurfaceCF;
+static	Uint32	LastAnimationBlit;
+static	bool	EnableAnimation;
+private:
+	bool		CheckLayer		(SDL_Surface *Target);
+	void		Draw			(SDL_Surface *Destination, Tableau &Model, Uint8 PlayerIndex, int Top);
+
+	SDL_Surface	*Layer;
+	Uint32		LayerStamp;
+	int			LayerLayout[TABLEAU_LAYOUT_VALUES];	// The dimensions Layer was drawn for
+	Surface		Backdrop,
+				BattleSurface,
+				LimitSurface,
+				MileageTextSurface,
+				SafetySurfaces[SAFETY_COUNT];
+static	Surface	MileageSurfaces[MILEAGE_PILES];
+static	TTF_Font	*MyFont;
+};
+
+}
+
+#endif
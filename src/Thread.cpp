@@ -0,0 +1,197 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Thread.h"
+
+#ifndef	_WIN32
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace _SDLMille
+{
+
+		Mutex::Mutex			(void)
+{
+	#ifdef	_WIN32
+	InitializeCriticalSection(&Handle);
+	#else
+	pthread_mutex_init(&Handle, 0);
+	#endif
+}
+
+		Mutex::~Mutex			(void)
+{
+	#ifdef	_WIN32
+	DeleteCriticalSection(&Handle);
+	#else
+	pthread_mutex_destroy(&Handle);
+	#endif
+}
+
+void	Mutex::Lock				(void)
+{
+	#ifdef	_WIN32
+	EnterCriticalSection(&Handle);
+	#else
+	pthread_mutex_lock(&Handle);
+	#endif
+}
+
+void	Mutex::Unlock			(void)
+{
+	#ifdef	_WIN32
+	LeaveCriticalSection(&Handle);
+	#else
+	pthread_mutex_unlock(&Handle);
+	#endif
+}
+
+		Thread::Thread			(void)
+{
+	Running = false;
+	Function = 0;
+	Data = 0;
+}
+
+		Thread::~Thread			(void)
+{
+	Wait();
+}
+
+#ifdef	_WIN32
+DWORD WINAPI	Thread::Entry	(LPVOID Self)
+#else
+void *	Thread::Entry			(void *Self)
+#endif
+{
+	Thread	*Me = (Thread *) Self;
+
+	Me->Function(Me->Data);
+
+	return 0;
+}
+
+Uint64	Thread::GetMicroseconds	(void)
+{
+	// For timing short stretches of work; the origin is arbitrary
+	#ifdef	_WIN32
+	LARGE_INTEGER	Now, Frequency;
+
+	QueryPerformanceCounter(&Now);
+	QueryPerformanceFrequency(&Frequency);
+
+	return (Uint64) ((Now.QuadPart / Frequency.QuadPart) * 1000000 + ((Now.QuadPart % Frequency.QuadPart) * 1000000) / Frequency.QuadPart);
+	#else
+	timeval	Now;
+
+	gettimeofday(&Now, 0);
+
+	return (Uint64) Now.tv_sec * 1000000 + Now.tv_usec;
+	#endif
+}
+
+Uint32	Thread::GetMilliseconds	(void)
+{
+	#ifdef	_WIN32
+	return GetTickCount();
+	#else
+	timeval	Now;
+
+	gettimeofday(&Now, 0);
+
+	return (Uint32) (Now.tv_sec * 1000 + Now.tv_usec / 1000);
+	#endif
+}
+
+Uint8	Thread::GetProcessorCount	(void)
+{
+	long	Count;
+
+	#ifdef	_WIN32
+	SYSTEM_INFO	Info;
+
+	GetSystemInfo(&Info);
+	Count = Info.dwNumberOfProcessors;
+	#else
+	Count = sysconf(_SC_NPROCESSORS_ONLN);
+	#endif
+
+	if (Count < 1)
+		return 1;
+	if (Count > 255)
+		return 255;
+
+	return (Uint8) Count;
+}
+
+Uint32	Thread::Increment		(volatile Uint32 &Value)
+{
+	// Atomic, so threads sharing a counter each get a value of their own
+	#ifdef	_WIN32
+	return (Uint32) InterlockedIncrement((volatile LONG *) &Value);
+	#else
+	return __sync_add_and_fetch(&Value, 1);
+	#endif
+}
+
+void	Thread::Sleep			(Uint32 Milliseconds)
+{
+	#ifdef	_WIN32
+	::Sleep(Milliseconds);
+	#else
+	usleep(Milliseconds * 1000);
+	#endif
+}
+
+bool	Thread::Start			(ThreadFunction NewFunction, void *NewData)
+{
+	if (Running)
+		return false;
+
+	Function = NewFunction;
+	Data = NewData;
+
+	#ifdef	_WIN32
+	Handle = CreateThread(0, 0, Entry, this, 0, 0);
+	Running = (Handle != 0);
+	#else
+	Running = (pthread_create(&Handle, 0, Entry, this) == 0);
+	#endif
+
+	return Running;
+}
+
+void	Thread::Wait			(void)
+{
+	if (!Running)
+		return;
+
+	#ifdef	_WIN32
+	WaitForSingleObject(Handle, INFINITE);
+	CloseHandle(Handle);
+	#else
+	pthread_join(Handle, 0);
+	#endif
+
+	Running = false;
+}
+
+}
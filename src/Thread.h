@@ -0,0 +1,97 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_THREAD_H
+#define	_SDLMILLE_THREAD_H
+
+#include "Types.h"
+
+#ifdef	_WIN32
+// This header reaches most of the tree; windows.h's min and max macros would break std::min and std::max
+#ifndef	NOMINMAX
+#define	NOMINMAX
+#endif
+#ifndef	WIN32_LEAN_AND_MEAN
+#define	WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace _SDLMille
+{
+
+/*	Minimal threading for the headless tools. The game itself uses SDL threads; the engine
+	and simulator stay free of SDL, so they get native threads here instead. */
+
+typedef	void	(*ThreadFunction)	(void *Data);
+
+class Mutex
+{
+public:
+				Mutex			(void);
+				~Mutex			(void);
+	void		Lock			(void);
+	void		Unlock			(void);
+private:
+				Mutex			(const Mutex &);
+	Mutex &		operator=		(const Mutex &);
+
+	#ifdef	_WIN32
+	CRITICAL_SECTION	Handle;
+	#else
+	pthread_mutex_t		Handle;
+	#endif
+};
+
+class Thread
+{
+public:
+				Thread			(void);
+				~Thread			(void);
+	bool		Start			(ThreadFunction Function, void *Data);
+	void		Wait			(void);
+
+	static	Uint64	GetMicroseconds		(void);
+	static	Uint32	GetMilliseconds		(void);
+	static	Uint8	GetProcessorCount	(void);
+	static	Uint32	Increment			(volatile Uint32 &Value);
+	static	void	Sleep				(Uint32 Milliseconds);
+private:
+				Thread			(const Thread &);
+	Thread &	operator=		(const Thread &);
+
+	#ifdef	_WIN32
+	static	DWORD WINAPI	Entry	(LPVOID Self);
+	HANDLE		Handle;
+	#else
+	static	void *	Entry		(void *Self);
+	pthread_t	Handle;
+	#endif
+
+	bool		Running;
+	ThreadFunction	Function;
+	void		*Data;
+};
+
+}
+
+#endif
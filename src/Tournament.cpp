@@ -0,0 +1,467 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Tournament.h"
+#include <math.h>
+#include <string.h>
+
+namespace _SDLMille
+{
+
+		Tournament::Tournament	(void)
+{
+	Cache = 0;
+	PolicyCount = 0;
+	PairingCount = 0;
+	ThreadCount = 0;
+	Milliseconds = 0;
+	Seed = 0;
+	ThinkTime = 0;
+	RecordPath = 0;
+	TracePath = 0;
+	Results = 0;
+	Tallies = 0;
+	Workers = 0;
+}
+
+		Tournament::~Tournament	(void)
+{
+	Clear();
+}
+
+void	Tournament::AddPairs	(Uint32 TaskCount)
+{
+	/*	The games of a pair are a round of pairings apart. An odd game out, or the other half
+		of a game with an error, makes a pair of one. */
+	for (Uint32 i = 0; i < TaskCount; ++i)
+	{
+		if (((i / PairingCount) % 2) == 1)
+			continue;
+
+		TournamentResult	&Result = Results[i % PairingCount];
+		double				Points = 0,
+							Scores[2] = {0, 0};
+		Uint32				Games = 0,
+							Hands = 0;
+
+		for (Uint32 j = i; (j < TaskCount) && (j <= i + PairingCount); j += PairingCount)
+		{
+			if (!Tallies[j].Played)
+				continue;
+
+			Points += Tallies[j].Points;
+			Scores[0] += Tallies[j].Scores[0];
+			Scores[1] += Tallies[j].Scores[1];
+			Hands += Tallies[j].Hands;
+			++Games;
+		}
+
+		if (Games == 0)
+			continue;
+
+		Points /= Games;
+
+		++Result.Pairs;
+		Result.PairPoints += Points;
+		Result.PairPointSquares += Points * Points;
+		Result.PairHandSquares += (double) Hands * Hands;
+
+		for (int k = 0; k < 2; ++k)
+		{
+			Result.PairScoreHands[k] += Scores[k] * Hands;
+			Result.PairScoreSquares[k] += Scores[k] * Scores[k];
+		}
+	}
+}
+
+bool	Tournament::AddPolicy	(Uint8 Level, const WeightTable *Weights)
+{
+	// Weights stay the caller's, and must outlive Run. None means the defaults.
+	if ((PolicyCount >= TOURNAMENT_POLICY_MAX) || (Level >= DIFFICULTY_LEVEL_COUNT))
+		return false;
+
+	Policies[PolicyCount] = Level;
+	PolicyWeights[PolicyCount] = Weights;
+	++PolicyCount;
+
+	return true;
+}
+
+void	Tournament::Clear		(void)
+{
+	if (Workers != 0)
+	{
+		for (int i = 0; i < ThreadCount; ++i)
+		{
+			if (Workers[i].TraceFile != 0)
+				fclose(Workers[i].TraceFile);
+
+			delete[] Workers[i].Tasks;
+			delete[] Workers[i].Results;
+		}
+
+		delete[] Workers;
+		Workers = 0;
+	}
+
+	if (Results != 0)
+	{
+		delete[] Results;
+		Results = 0;
+	}
+
+	if (Tallies != 0)
+	{
+		delete[] Tallies;
+		Tallies = 0;
+	}
+
+	PairingCount = 0;
+	ThreadCount = 0;
+	Milliseconds = 0;
+}
+
+double	Tournament::GetAverageScore	(const TournamentResult &Result, Uint8 Side, double &Margin)
+{
+	/*	The average is over every hand, and so a ratio of pair totals; its margin comes from
+		how far each pair's score total strays from what the average makes of its hands. */
+	double	Average, Spread;
+
+	Margin = 0;
+
+	if (Result.Hands == 0)
+		return 0;
+
+	Average = Result.ScoreTotals[Side] / Result.Hands;
+	Spread = Result.PairScoreSquares[Side] - (2 * Average * Result.PairScoreHands[Side]) + (Average * Average * Result.PairHandSquares);
+
+	if (Spread > 0)
+		Margin = TOURNAMENT_Z * sqrt(Spread) / Result.Hands;
+
+	return Average;
+}
+
+double	Tournament::GetScoreRate	(const TournamentResult &Result, double &Margin)
+{
+	/*	A win counts 1 and a draw counts 1/2, so the rate is the share of the points the
+		first policy took. The margin is the normal approximation on the points of each
+		seat-swapped pair. */
+	double	Rate, Variance,
+			Wins = Result.Outcomes[OUTCOME_WON],
+			Draws = Result.Outcomes[OUTCOME_DRAW];
+
+	Margin = 0;
+
+	if ((Result.Games == 0) || (Result.Pairs == 0))
+		return 0;
+
+	Rate = (Wins + Draws / 2) / Result.Games;
+	Variance = (Result.PairPointSquares / Result.Pairs) - (2 * Rate * Result.PairPoints / Result.Pairs) + (Rate * Rate);
+
+	if (Variance > 0)
+		Margin = TOURNAMENT_Z * sqrt(Variance / Result.Pairs);
+
+	return Rate;
+}
+
+void	Tournament::Play		(Worker &Self, const Task &Next)
+{
+	TournamentResult	&Result = Self.Results[Next.Pairing];
+	Tally				&Game = Tallies[Next.Index];
+	Engine				Rules(Next.Seed);
+	Simulator			Sim;
+	Uint8				Levels[PLAYER_COUNT],
+						Outcome;
+
+	// Side 0 is the pairing's first policy; Swapped puts it in the second seat
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		Uint8	Side = Next.Swapped ? (1 - i) : i;
+
+		Levels[i] = Result.Policies[Side];
+		Rules.SetWeights(i, PolicyWeights[Result.Entrants[Side]]);
+	}
+
+	if (TracePath != 0)
+		Rules.SetTrace(&Self.Trace);
+
+	Rules.SetCache(Cache);
+
+	if (Log.IsOpen())
+		Sim.SetRecorder(&Self.Recorder);
+
+	Sim.SetThinkTime(ThinkTime);
+
+	Outcome = Sim.PlayGame(Rules, Levels);
+
+	if (Sim.GetErrors() > 0)
+	{
+		++Result.Errors;
+		return;
+	}
+
+	if (Next.Swapped && (Outcome != OUTCOME_DRAW))
+		Outcome = (Outcome == OUTCOME_WON) ? OUTCOME_LOST : OUTCOME_WON;
+
+	++Result.Games;
+	++Result.Outcomes[Outcome];
+	Result.Hands += Sim.GetHands();
+
+	Game.Points = (Outcome == OUTCOME_WON) ? 1 : ((Outcome == OUTCOME_DRAW) ? 0.5 : 0);
+	Game.Hands = Sim.GetHands();
+	Game.Played = true;
+
+	for (int i = 0; i < PLAYER_COUNT; ++i)
+	{
+		Uint8	Seat = Next.Swapped ? (1 - i) : i;
+
+		Game.Scores[i] = Sim.GetScoreTotal(Seat);
+		Result.ScoreTotals[i] += Game.Scores[i];
+	}
+
+	++Self.Games;
+}
+
+bool	Tournament::Run			(Uint32 GamesPerPairing, Uint8 NewThreadCount, Uint64 NewSeed, bool Gauntlet)
+{
+	Uint32	Capacity, TaskCount, Start;
+
+	Clear();
+	Seed = NewSeed;
+
+	if ((PolicyCount == 0) || (GamesPerPairing == 0))
+		return false;
+
+	/*	Every policy meets every other once, or in a gauntlet each challenger meets the first
+		policy, and is the first side of its pairing. A lone policy plays itself. */
+	if (PolicyCount == 1)
+		PairingCount = 1;
+	else if (Gauntlet)
+		PairingCount = PolicyCount - 1;
+	else
+		PairingCount = (PolicyCount * (PolicyCount - 1)) / 2;
+
+	Results = new TournamentResult[PairingCount];
+	memset(Results, 0, sizeof(TournamentResult) * PairingCount);
+
+	if (PolicyCount == 1)
+		SetEntrants(Results[0], 0, 0);
+	else if (Gauntlet)
+	{
+		for (int i = 1; i < PolicyCount; ++i)
+			SetEntrants(Results[i - 1], i, 0);
+	}
+	else
+	{
+		Uint16	Pairing = 0;
+
+		for (int i = 0; i < PolicyCount; ++i)
+		{
+			for (int j = i + 1; j < PolicyCount; ++j)
+			{
+				SetEntrants(Results[Pairing], i, j);
+				++Pairing;
+			}
+		}
+	}
+
+	ThreadCount = (NewThreadCount > 0) ? NewThreadCount : 1;
+	TaskCount = GamesPerPairing * PairingCount;
+	Capacity = (TaskCount + ThreadCount - 1) / ThreadCount;
+	Tallies = new Tally[TaskCount];
+	memset(Tallies, 0, sizeof(Tally) * TaskCount);
+	Workers = new Worker[ThreadCount];
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		Workers[i].Owner = this;
+		Workers[i].Index = i;
+		Workers[i].Tasks = new Task[Capacity];
+		Workers[i].Head = 0;
+		Workers[i].Tail = 0;
+		Workers[i].Games = 0;
+		Workers[i].Milliseconds = 0;
+		Workers[i].Results = new TournamentResult[PairingCount];
+		memcpy(Workers[i].Results, Results, sizeof(TournamentResult) * PairingCount);
+		Workers[i].Trace.Clear();
+		Workers[i].TraceFile = (TracePath != 0) ? tmpfile() : 0;
+		Workers[i].Trace.SetSink(Workers[i].TraceFile);
+		Workers[i].Recorder.SetLog(&Log);
+	}
+
+	/*	Deal the games out like cards, alternating seats, so every queue gets a similar mix.
+		Both games of a seat-swapped pair get the same seed and so the same cards, which
+		takes the luck of the deal out of the comparison. A gauntlet also shares seeds
+		across its pairings. */
+	for (Uint32 i = 0; i < TaskCount; ++i)
+	{
+		Worker	&Owner = Workers[i % ThreadCount];
+		Task	&Dealt = Owner.Tasks[Owner.Tail];
+		Uint32	Round = i / PairingCount;
+		Uint64	Value = Gauntlet ? (Seed + Round / 2) : (Seed + (Uint64) (Round / 2) * PairingCount + (i % PairingCount));
+
+		Dealt.Seed = Random::Mix(Value);
+		Dealt.Index = i;
+		Dealt.Pairing = i % PairingCount;
+		Dealt.Swapped = (Round % 2) == 1;
+		++Owner.Tail;
+	}
+
+	if ((RecordPath != 0) && !Log.Open(RecordPath))
+		return false;
+
+	Start = Thread::GetMilliseconds();
+
+	/*	The calling thread works too. If a thread fails to start, its queue is simply stolen
+		from until it is empty. */
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Start(WorkerMain, &Workers[i]);
+
+	WorkerMain(&Workers[0]);
+
+	for (int i = 1; i < ThreadCount; ++i)
+		Workers[i].Runner.Wait();
+
+	Milliseconds = Thread::GetMilliseconds() - Start;
+
+	if (Log.IsOpen())
+	{
+		for (int i = 0; i < ThreadCount; ++i)
+			Workers[i].Recorder.Flush();
+
+		if (!Log.Close())
+			return false;
+	}
+
+	if ((TracePath != 0) && !SaveTraces())
+		return false;
+
+	// Merge
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		for (int j = 0; j < PairingCount; ++j)
+		{
+			TournamentResult	&From = Workers[i].Results[j],
+								&To = Results[j];
+
+			To.Errors += From.Errors;
+			To.Games += From.Games;
+			To.Hands += From.Hands;
+
+			for (int k = 0; k <= OUTCOME_NOT_OVER; ++k)
+				To.Outcomes[k] += From.Outcomes[k];
+
+			for (int k = 0; k < 2; ++k)
+				To.ScoreTotals[k] += From.ScoreTotals[k];
+		}
+	}
+
+	AddPairs(TaskCount);
+
+	return true;
+}
+
+bool	Tournament::SaveTraces	(void)
+{
+	// Each worker's trace, in thread order
+	FILE	*TraceFile = fopen(TracePath, "wb");
+	bool	Saved = (TraceFile != 0);
+
+	for (int i = 0; i < ThreadCount; ++i)
+	{
+		Worker	&Self = Workers[i];
+		char	Buffer[4096];
+		size_t	Length;
+
+		if (Self.TraceFile == 0)
+		{
+			Saved = false;
+			continue;
+		}
+
+		Saved = Self.Trace.Drain(Self.TraceFile, true) && Saved;
+		rewind(Self.TraceFile);
+
+		while (Saved && ((Length = fread(Buffer, 1, sizeof(Buffer), Self.TraceFile)) > 0))
+			Saved = (fwrite(Buffer, 1, Length, TraceFile) == Length);
+
+		fclose(Self.TraceFile);
+		Self.TraceFile = 0;
+	}
+
+	if (TraceFile != 0)
+		fclose(TraceFile);
+
+	return Saved;
+}
+
+void	Tournament::SetEntrants	(TournamentResult &Result, Uint8 First, Uint8 Second)	const
+{
+	Result.Entrants[0] = First;
+	Result.Entrants[1] = Second;
+	Result.Policies[0] = Policies[First];
+	Result.Policies[1] = Policies[Second];
+}
+
+bool	Tournament::TakeTask	(Worker &Self, Task &Next)
+{
+	bool	Found = false;
+
+	// Own queue first, from the back
+	Self.QueueLock.Lock();
+	if (Self.Head < Self.Tail)
+	{
+		--Self.Tail;
+		Next = Self.Tasks[Self.Tail];
+		Found = true;
+	}
+	Self.QueueLock.Unlock();
+
+	// Then steal from the front of the others', starting with the next one along
+	for (int i = 1; !Found && (i < ThreadCount); ++i)
+	{
+		Worker	&Victim = Workers[(Self.Index + i) % ThreadCount];
+
+		Victim.QueueLock.Lock();
+		if (Victim.Head < Victim.Tail)
+		{
+			Next = Victim.Tasks[Victim.Head];
+			++Victim.Head;
+			Found = true;
+		}
+		Victim.QueueLock.Unlock();
+	}
+
+	return Found;
+}
+
+void	Tournament::WorkerMain	(void *Data)
+{
+	Worker	&Self = *((Worker *) Data);
+	Uint32	Start = Thread::GetMilliseconds();
+	Task	Next;
+
+	while (Self.Owner->TakeTask(Self, Next))
+		Self.Owner->Play(Self, Next);
+
+	Self.Milliseconds = Thread::GetMilliseconds() - Start;
+}
+
+}
@@ -0,0 +1,225 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_TOURNAMENT_H
+#define	_SDLMILLE_TOURNAMENT_H
+
+#include "Simulator.h"
+#include "Thread.h"
+
+namespace _SDLMille
+{
+
+const	Uint8	TOURNAMENT_POLICY_MAX = 64;
+const	double	TOURNAMENT_Z = 1.96;	// 95% confidence intervals
+
+/*	Results of one pairing, from the point of view of the first policy. Each side plays half
+	its games from each seat, since the first player to move has an edge. Policies holds the
+	difficulty levels and Entrants the order the policies were added in.
+
+	The two games of a seat-swapped pair are dealt the same cards, so they are far from
+	independent. The Pair sums treat each pair as one sample, for the confidence margins:
+	a pair's points are the average of its games', and its scores and hands are totals. */
+
+struct TournamentResult
+{
+	Uint8		Entrants[2],
+				Policies[2];
+	Uint32		Errors,
+				Games,
+				Hands,
+				Outcomes[OUTCOME_NOT_OVER + 1],
+				Pairs;
+	double		PairHandSquares,
+				PairPoints,
+				PairPointSquares,
+				PairScoreHands[2],		// Each pair's score total times its hands
+				PairScoreSquares[2],
+				ScoreTotals[2];
+};
+
+/*	Round-robin between computer players, one game per task, on a pool of worker threads.
+	Every game is dealt from its own seed, derived from the tournament's, so a run replays
+	exactly whichever thread ends up playing each game. Each worker owns a queue of tasks and takes from its back; when that runs dry it steals
+	from the front of another worker's queue. Workers keep their own results and the pool
+	merges them at the end, so nothing but the queues is shared while games are running.
+
+	A gauntlet plays every other policy against the first one instead, and deals each of
+	them the same games, so the differences between challengers aren't down to their cards.
+
+	With a trace path set, each worker records its decisions in its own DecisionTrace, which
+	spills to a temporary file, and Run joins them into one binary trace at the end.
+
+	With a record path set, every move chosen is written there for training (see
+	TrainingRecorder), each worker recording its own games through one shared TrainingLog.
+
+	A DecisionCache, if set, is shared by every game on every thread; it stays the caller's
+	and keeps its counts across runs. */
+
+class Tournament
+{
+public:
+				Tournament		(void);
+				~Tournament		(void);
+	bool		AddPolicy		(Uint8 Level, const WeightTable *Weights = 0);
+	DecisionCache *	GetCache	(void)							const;
+	Uint32		GetMilliseconds	(void)							const;
+	Uint64		GetRecords		(void)							const;
+	Uint64		GetSeed			(void)							const;
+	Uint16		GetPairingCount	(void)							const;
+	const TournamentResult &	GetResult	(Uint16 Pairing)	const;
+	Uint8		GetThreadCount	(void)							const;
+	Uint32		GetThreadGames	(Uint8 ThreadIndex)				const;
+	Uint32		GetThreadMilliseconds	(Uint8 ThreadIndex)		const;
+	bool		Run				(Uint32 GamesPerPairing, Uint8 ThreadCount, Uint64 NewSeed, bool Gauntlet = false);
+	void		SetCache		(DecisionCache *NewCache);
+	void		SetRecordPath	(const char *Path);
+	void		SetThinkTime	(Uint32 NewThinkTime);
+	void		SetTracePath	(const char *Path);
+
+	static	double	GetAverageScore	(const TournamentResult &Result, Uint8 Side, double &Margin);
+	static	double	GetScoreRate	(const TournamentResult &Result, double &Margin);
+private:
+	struct Task
+	{
+		Uint64	Seed;
+		Uint32	Index;
+		Uint16	Pairing;
+		bool	Swapped;
+	};
+
+	struct Tally		// One game's result, until it is added to its pair's
+	{
+		double	Points,
+				Scores[2];
+		Uint32	Hands;
+		bool	Played;
+	};
+
+	struct Worker
+	{
+		Tournament	*Owner;
+		Uint8		Index;
+		Thread		Runner;
+		Mutex		QueueLock;
+		Task		*Tasks;
+		Uint32		Head, Tail,
+					Games,
+					Milliseconds;
+		TournamentResult	*Results;
+		DecisionTrace	Trace;
+		FILE		*TraceFile;
+		TrainingRecorder	Recorder;
+	};
+
+	void		AddPairs		(Uint32 TaskCount);
+	void		Clear			(void);
+	void		Play			(Worker &Self, const Task &Next);
+	bool		SaveTraces		(void);
+	void		SetEntrants		(TournamentResult &Result, Uint8 First, Uint8 Second)	const;
+	bool		TakeTask		(Worker &Self, Task &Next);
+
+	static	void	WorkerMain	(void *Data);
+
+	Uint16		PairingCount;
+	Uint8		PolicyCount,
+				Policies[TOURNAMENT_POLICY_MAX],
+				ThreadCount;
+	const WeightTable	*PolicyWeights[TOURNAMENT_POLICY_MAX];
+	DecisionCache	*Cache;
+	Uint32		Milliseconds,
+				ThinkTime;
+	Uint64		Seed;
+	const char	*RecordPath,
+				*TracePath;
+	TrainingLog	Log;
+	TournamentResult	*Results;
+	Tally		*Tallies;		// One per task, each written by whichever worker plays it
+	Worker		*Workers;
+};
+
+inline	DecisionCache *	Tournament::GetCache	(void)				const
+{
+	return Cache;
+}
+
+inline	Uint32	Tournament::GetMilliseconds	(void)						const
+{
+	return Milliseconds;
+}
+
+inline	Uint64	Tournament::GetRecords		(void)						const
+{
+	return Log.GetRecords();
+}
+
+inline	Uint64	Tournament::GetSeed			(void)						const
+{
+	return Seed;
+}
+
+inline	Uint16	Tournament::GetPairingCount	(void)						const
+{
+	return PairingCount;
+}
+
+inline	const TournamentResult &	Tournament::GetResult	(Uint16 Pairing)	const
+{
+	return Results[Pairing];
+}
+
+inline	void	Tournament::SetCache		(DecisionCache *NewCache)
+{
+	Cache = NewCache;
+}
+
+inline	void	Tournament::SetRecordPath	(const char *Path)
+{
+	RecordPath = Path;
+}
+
+inline	void	Tournament::SetThinkTime	(Uint32 NewThinkTime)
+{
+	ThinkTime = NewThinkTime;
+}
+
+inline	void	Tournament::SetTracePath	(const char *Path)
+{
+	TracePath = Path;
+}
+
+inline	Uint8	Tournament::GetThreadCount	(void)						const
+{
+	return ThreadCount;
+}
+
+inline	Uint32	Tournament::GetThreadGames	(Uint8 ThreadIndex)			const
+{
+	return Workers[ThreadIndex].Games;
+}
+
+inline	Uint32	Tournament::GetThreadMilliseconds	(Uint8 ThreadIndex)	const
+{
+	return Workers[ThreadIndex].Milliseconds;
+}
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Trace.h"
+
+namespace _SDLMille
+{
+
+namespace
+{
+
+const	char	*TRACE_TEXT[TRACE_COUNT] = {
+			"A00: Coup Fourre",
+			"A10: Game almost over",
+			"A20: Play safeties so we can snatch up the last few cards",
+			"A30: RoW, no hazards left",
+			"A40: RoW to get rolling. Have no roll cards",
+			"A50: RoW to remove limit. Have no end-limit card",
+			"A52: No more roll cards. Playing RoW",
+			"A54: No more speed remedies. Playing RoW",
+			"A56: General Right-of-Way safety",
+			"A60: No more hazards",
+			"A70: Getting out of a jam",
+			"A80: General safety",
+			"B00: We have the safety",
+			"B03: We can roll",
+			"B06: More than min(3, OutstandingStopHazards) roll cards",
+			"B09: Roll card with RoW in hand",
+			"B12: Roll card without RoW in hand",
+			"B20: Remedy for current hazard",
+			"B30: Exhausted hazard, more than we need, or we hold the safety",
+			"B40: General remedy",
+			"B42: Reduced weight because we hold more than one",
+			"B44: Increased weight because it's almost exhausted",
+			"B46: Reduced weight by known hazards",
+			"C00: Opponent has safety",
+			"C03: Saving speed limit",
+			"C06: Don't risk giving away the shutout",
+			"C10: Must stop opponent",
+			"C20: General hazard",
+			"C20: Increased weight by known remedies",
+			"C30: Opponent could not hold remedy",
+			"C40: Opponent could not hold safety",
+			"C50: Reduced weight for speed limit because opponent is rolling",
+			"D00: Goes past end of trip",
+			"D03: Unusable 200",
+			"D06: More than we can use",
+			"D09: Deferring to other mileage held in hand",
+			"D12: Let's wrap it up",
+			"D15: Would leave us with only 25 left",
+			"D18: We need to catch up, or we've already played",
+			"D21: No need to play it",
+			"D30: Takes us exactly to end of hand",
+			"D35: Complimentary mileage to finish trip",
+			"D36: Complimentary mileage to finish trip",
+			"D40: Balance of 100",
+			"D43: Balance greater than 50",
+			"D46: Balance of 50",
+			"D48: Balance of 25, more than one in hand",
+			"D49: Balance of 25, keep it",
+			"D60: Nearing end; balance greater than 100",
+			"D70: Saving 25 because there's no 50",
+			"D75: Saving 50",
+			"D80: Weighted on mileage",
+			"Outstanding stop hazards",
+			"Total weight",
+			"Play",
+			"Discard"	};
+
+}
+
+		DecisionTrace::DecisionTrace	(void)
+{
+	Count = 0;
+	Dropped = 0;
+	Next = 0;
+	Sink = 0;
+}
+
+void	DecisionTrace::Clear		(void)
+{
+	Count = 0;
+	Next = 0;
+}
+
+bool	DecisionTrace::Drain		(FILE *Out, bool Binary)
+{
+	// Oldest first; the buffer is emptied even if the write fails
+	Uint32	First = (Next - Count) & (TRACE_CAPACITY - 1);
+	bool	Written = (Out != 0);
+
+	for (Uint32 i = 0; Written && (i < Count); ++i)
+	{
+		const TraceRecord	&Entry = Records[(First + i) & (TRACE_CAPACITY - 1)];
+
+		if (Binary)
+		{
+			Uint8	Bytes[TRACE_RECORD_SIZE] = {Entry.Rule, Entry.Player, Entry.Index, Entry.Value,
+											(Uint8) (Entry.Delta & 0xFF), (Uint8) ((Entry.Delta >> 8) & 0xFF)};
+
+			Written = (fwrite(Bytes, 1, TRACE_RECORD_SIZE, Out) == TRACE_RECORD_SIZE);
+		}
+		else
+			Print(Out, Entry);
+	}
+
+	Clear();
+
+	return Written;
+}
+
+bool	DecisionTrace::Dump			(FILE *In, FILE *Out)
+{
+	Uint8	Bytes[TRACE_RECORD_SIZE];
+
+	if ((In == 0) || (Out == 0))
+		return false;
+
+	while (fread(Bytes, 1, TRACE_RECORD_SIZE, In) == TRACE_RECORD_SIZE)
+	{
+		TraceRecord	Entry;
+
+		if (Bytes[0] >= TRACE_COUNT)
+			return false;
+
+		Entry.Rule = Bytes[0];
+		Entry.Player = Bytes[1];
+		Entry.Index = Bytes[2];
+		Entry.Value = Bytes[3];
+		Entry.Delta = (Sint16) (Bytes[4] | (Bytes[5] << 8));
+
+		Print(Out, Entry);
+	}
+
+	return true;
+}
+
+/* Private methods */
+
+void	DecisionTrace::Print		(FILE *Out, const TraceRecord &Entry)
+{
+	if (Entry.Index >= HAND_SIZE)
+		fprintf(Out, "Player %u: %s %d\n", Entry.Player, TRACE_TEXT[Entry.Rule], Entry.Delta);
+	else if (Card::GetTypeFromValue(Entry.Value) == CARD_MILEAGE)
+		fprintf(Out, "Player %u, slot %u (%u): %s %+d\n", Entry.Player, Entry.Index, Card::GetMileValue(Entry.Value), TRACE_TEXT[Entry.Rule], Entry.Delta);
+	else if (Entry.Value <= CARD_SAFETY_RIGHT_OF_WAY)
+		fprintf(Out, "Player %u, slot %u (%s): %s %+d\n", Entry.Player, Entry.Index, CARD_CAPTIONS[Entry.Value], TRACE_TEXT[Entry.Rule], Entry.Delta);
+	else
+		fprintf(Out, "Player %u, slot %u: %s %+d\n", Entry.Player, Entry.Index, TRACE_TEXT[Entry.Rule], Entry.Delta);
+}
+
+}
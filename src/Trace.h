@@ -0,0 +1,130 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_TRACE_H
+#define	_SDLMILLE_TRACE_H
+
+#include "Hand.h"
+#include <stdio.h>
+
+namespace _SDLMille
+{
+
+/*	Records why ComputerSmartMove weighed each card the way it did. Build with
+	TRACE_DECISIONS defined to turn it on; otherwise TRACE_DECISION expands to nothing and
+	the AI pays nothing for it. */
+
+#ifdef	TRACE_DECISIONS
+	#define	TRACE_DECISION(Trace, Rule, Player, Index, Value, Delta)	do { if ((Trace) != 0) (Trace)->Record((Rule), (Player), (Index), (Value), (Delta)); } while (0)
+#else
+	#define	TRACE_DECISION(Trace, Rule, Player, Index, Value, Delta)	do {} while (0)
+#endif
+
+// One per rule of thumb, named by its ID, followed by the records that aren't rules
+enum	{	TRACE_A00 = 0, TRACE_A10, TRACE_A20, TRACE_A30, TRACE_A40, TRACE_A50, TRACE_A52, TRACE_A54,
+			TRACE_A56, TRACE_A60, TRACE_A70, TRACE_A80, TRACE_B00, TRACE_B03, TRACE_B06, TRACE_B09,
+			TRACE_B12, TRACE_B20, TRACE_B30, TRACE_B40, TRACE_B42, TRACE_B44, TRACE_B46, TRACE_C00,
+			TRACE_C03, TRACE_C06, TRACE_C10, TRACE_C20, TRACE_C20_KNOWN, TRACE_C30, TRACE_C40, TRACE_C50,
+			TRACE_D00, TRACE_D03, TRACE_D06, TRACE_D09, TRACE_D12, TRACE_D15, TRACE_D18, TRACE_D21,
+			TRACE_D30, TRACE_D35, TRACE_D36, TRACE_D40, TRACE_D43, TRACE_D46, TRACE_D48, TRACE_D49,
+			TRACE_D60, TRACE_D70, TRACE_D75, TRACE_D80, TRACE_STOP_HAZARDS, TRACE_WEIGHT, TRACE_PLAY, TRACE_DISCARD,
+			TRACE_COUNT	};
+
+const	Uint32	TRACE_CAPACITY = 4096,	// Records; must be a power of two
+				TRACE_RECORD_SIZE = 6;	// Bytes per record in a binary trace
+
+struct TraceRecord
+{
+	Sint16		Delta;		// The change in the card's weight, or the value the record reports
+	Uint8		Index,		// Hand slot, or 0xFF if the record isn't about one card
+				Player,
+				Rule,
+				Value;
+};
+
+/*	A ring buffer of TraceRecords. It has no locks because only one thread ever writes to
+	it: each thread that plays games gives its Engine a trace of its own. When it fills up it
+	drains itself to its sink if it has one, and otherwise overwrites the oldest records.
+
+	A binary trace is a run of 6-byte records: rule, player, slot, card value, then the
+	delta as a little-endian 16-bit integer. Dump turns one back into text. */
+
+class DecisionTrace
+{
+public:
+				DecisionTrace	(void);
+	void		Clear			(void);
+	bool		Drain			(FILE *Out, bool Binary);
+	Uint32		GetCount		(void)						const;
+	Uint32		GetDropped		(void)						const;
+	void		Record			(Uint8 Rule, Uint8 Player, Uint8 Index, Uint8 Value, int Delta);
+	void		SetSink			(FILE *NewSink);
+
+	static	bool	Dump		(FILE *In, FILE *Out);
+private:
+	static	void	Print		(FILE *Out, const TraceRecord &Entry);
+
+	TraceRecord	Records[TRACE_CAPACITY];
+	Uint32		Count,
+				Dropped,
+				Next;
+	FILE		*Sink;
+};
+
+inline	Uint32	DecisionTrace::GetCount		(void)			const
+{
+	return Count;
+}
+
+inline	Uint32	DecisionTrace::GetDropped	(void)			const
+{
+	return Dropped;
+}
+
+inline	void	DecisionTrace::Record		(Uint8 Rule, Uint8 Player, Uint8 Index, Uint8 Value, int Delta)
+{
+	if (Count == TRACE_CAPACITY)
+	{
+		if (Sink != 0)
+			Drain(Sink, true);
+		else
+			++Dropped;	// The oldest record is about to be overwritten
+	}
+
+	TraceRecord	&Entry = Records[Next];
+
+	Entry.Delta = Delta;
+	Entry.Index = Index;
+	Entry.Player = Player;
+	Entry.Rule = Rule;
+	Entry.Value = Value;
+
+	Next = (Next + 1) & (TRACE_CAPACITY - 1);
+	if (Count < TRACE_CAPACITY)
+		++Count;
+}
+
+inline	void	DecisionTrace::SetSink		(FILE *NewSink)
+{
+	Sink = NewSink;
+}
+
+}
+
+#endif
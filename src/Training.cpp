@@ -0,0 +1,397 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+
+#include "Training.h"
+#include <string.h>
+
+namespace _SDLMille
+{
+
+namespace
+{
+
+// Where each field sits in a record
+const	Uint32	FIELD_STATE = 0,
+				FIELD_SCORES = 46,
+				FIELD_PLAYER = 50,
+				FIELD_LEVEL = 51,
+				FIELD_MOVE = 52,
+				FIELD_OUTCOME = 53,
+				FIELD_LEGAL = 54,
+				FIELD_MARGIN = 56,
+				FIELD_PLY = 58,
+				FIELD_HAND = 59,
+				FIELD_GAME = 60;
+
+const	char	TRAINING_MAGIC[] = "MTR1",
+				TRAINING_SCHEMA[] = "state:46 scores:s16*2 player:u8 level:u8 move:u8 outcome:u8 legal:u16 margin:s16 ply:u8 hand:u8 game:u32";
+
+// Fails to compile if the field list outgrows the header
+typedef	char	SchemaSizeCheck[(sizeof(TRAINING_SCHEMA) <= TRAINING_HEADER_SIZE - 12) ? 1 : -1];
+
+void	PutUint16	(Uint8 *Out, Uint16 Value)
+{
+	Out[0] = Value & 0xFF;
+	Out[1] = Value >> 8;
+}
+
+void	PutUint32	(Uint8 *Out, Uint32 Value)
+{
+	for (int i = 0; i < 4; ++i)
+		Out[i] = (Value >> (i * 8)) & 0xFF;
+}
+
+void	PutState	(Uint8 *Out, const GameState &State)
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		const PlayerState	&Side = State.Players[i];
+
+		memcpy(Out, Side.Table.Piles, sizeof(Side.Table.Piles));
+		Out += sizeof(Side.Table.Piles);
+		*Out++ = Side.Table.LimitCard;
+		*Out++ = Side.Table.OldLimitCard;
+		*Out++ = Side.Table.TopCard;
+		*Out++ = Side.Table.OldTopCard;
+		*Out++ = Side.Table.Safeties;
+		memcpy(Out, Side.Cards, HAND_SIZE);
+		Out += HAND_SIZE;
+		*Out++ = Side.QualifiedCoupFourre;
+	}
+
+	memcpy(Out, State.ExposedCards, sizeof(State.ExposedCards));
+	Out += sizeof(State.ExposedCards);
+	*Out++ = State.CardsLeft;
+	*Out++ = State.Current;
+	*Out++ = State.DiscardTop;
+	*Out++ = State.Flags;
+
+	for (int i = 0; i < 2; ++i)
+		PutUint16(Out + i * 2, (Uint16) State.RunningScores[i]);
+}
+
+void	MakeHeader	(Uint8 *Header)
+{
+	memset(Header, 0, TRAINING_HEADER_SIZE);
+	memcpy(Header, TRAINING_MAGIC, 4);
+	PutUint32(Header + 4, TRAINING_HEADER_SIZE);
+	PutUint32(Header + 8, TRAINING_RECORD_SIZE);
+	memcpy(Header + 12, TRAINING_SCHEMA, sizeof(TRAINING_SCHEMA));
+}
+
+}
+
+/* Public methods */
+
+		TrainingLog::TrainingLog		(void)
+{
+	File = 0;
+	Records = 0;
+	Failed = false;
+	Stopping = false;
+}
+
+		TrainingLog::~TrainingLog		(void)
+{
+	if (File != 0)
+		Close();
+}
+
+TrainingBlock *	TrainingLog::Acquire	(void)
+{
+	TrainingBlock	*Block = 0;
+
+	for (;;)
+	{
+		Lock.Lock();
+		if (!Free.empty())
+		{
+			Block = Free.back();
+			Free.pop_back();
+		}
+		else if (Blocks.size() < TRAINING_BLOCK_MAX)
+		{
+			Block = new TrainingBlock;
+			Blocks.push_back(Block);
+		}
+		Lock.Unlock();
+
+		if (Block != 0)
+			break;
+
+		// The disk has fallen behind; wait for the writer to hand a block back
+		Thread::Sleep(1);
+	}
+
+	Block->Count = 0;
+
+	return Block;
+}
+
+bool	TrainingLog::Close			(void)
+{
+	bool	Saved;
+
+	if (File == 0)
+		return false;
+
+	// The writer empties the queue before it stops
+	Lock.Lock();
+	Stopping = true;
+	Lock.Unlock();
+
+	Writer.Wait();
+
+	Saved = (fclose(File) == 0) && !Failed;
+	File = 0;
+
+	for (unsigned int i = 0; i < Blocks.size(); ++i)
+		delete Blocks[i];
+
+	Blocks.clear();
+	Free.clear();
+	Full.clear();
+
+	return Saved;
+}
+
+bool	TrainingLog::Open			(const char *Path)
+{
+	FILE	*Existing;
+	Uint8	Header[TRAINING_HEADER_SIZE],
+			Found[TRAINING_HEADER_SIZE];
+	size_t	Length = 0;
+
+	if (File != 0)
+		return false;
+
+	MakeHeader(Header);
+
+	Existing = fopen(Path, "rb");
+	if (Existing != 0)
+	{
+		Length = fread(Found, 1, TRAINING_HEADER_SIZE, Existing);
+		fclose(Existing);
+	}
+
+	// A new file gets a header; an old one must have the same one, and is added to
+	if (Length == 0)
+	{
+		File = fopen(Path, "wb");
+		if ((File != 0) && (fwrite(Header, 1, TRAINING_HEADER_SIZE, File) != TRAINING_HEADER_SIZE))
+		{
+			fclose(File);
+			File = 0;
+		}
+	}
+	else if ((Length == TRAINING_HEADER_SIZE) && (memcmp(Header, Found, TRAINING_HEADER_SIZE) == 0))
+		File = fopen(Path, "ab");
+
+	if (File == 0)
+		return false;
+
+	Records = 0;
+	Failed = false;
+	Stopping = false;
+
+	if (!Writer.Start(WriterMain, this))
+	{
+		fclose(File);
+		File = 0;
+		return false;
+	}
+
+	return true;
+}
+
+void	TrainingLog::Submit			(TrainingBlock *Block)
+{
+	Lock.Lock();
+	if (Block->Count > 0)
+		Full.push_back(Block);
+	else
+		Free.push_back(Block);
+	Lock.Unlock();
+}
+
+		TrainingRecorder::TrainingRecorder	(void)
+{
+	Log = 0;
+	Block = 0;
+	HandStart = 0;
+	Hand = 0;
+	Ply = 0;
+}
+
+void	TrainingRecorder::Abandon		(void)
+{
+	// Forgets the game in progress, say because it went wrong
+	Pending.clear();
+	HandStart = 0;
+	Hand = 0;
+	Ply = 0;
+}
+
+void	TrainingRecorder::Flush			(void)
+{
+	if ((Log != 0) && (Block != 0))
+	{
+		Log->Submit(Block);
+		Block = 0;
+	}
+}
+
+void	TrainingRecorder::OnGameOver	(Uint8 Outcome)
+{
+	// Outcome is from the first player's point of view, as Engine::GetOutcome gives it
+	if (Log == 0)
+		return;
+
+	for (unsigned int i = 0; i < Pending.size(); ++i)
+	{
+		Uint8	*Bytes = Pending[i].Bytes;
+
+		if ((Bytes[FIELD_PLAYER] == 0) || (Outcome == OUTCOME_DRAW) || (Outcome == OUTCOME_NOT_OVER))
+			Bytes[FIELD_OUTCOME] = Outcome;
+		else
+			Bytes[FIELD_OUTCOME] = (Outcome == OUTCOME_WON) ? OUTCOME_LOST : OUTCOME_WON;
+
+		if (Block == 0)
+			Block = Log->Acquire();
+
+		memcpy(Block->Bytes + Block->Count * TRAINING_RECORD_SIZE, Bytes, TRAINING_RECORD_SIZE);
+
+		if (++Block->Count == TRAINING_BLOCK_RECORDS)
+		{
+			Log->Submit(Block);
+			Block = 0;
+		}
+	}
+
+	Abandon();
+}
+
+void	TrainingRecorder::OnHandOver	(const Engine &Rules)
+{
+	// Call after GetScores
+	for (unsigned int i = HandStart; i < Pending.size(); ++i)
+	{
+		Uint8	*Bytes = Pending[i].Bytes,
+				Mover = Bytes[FIELD_PLAYER];
+
+		PutUint16(Bytes + FIELD_MARGIN, (Uint16) (Rules.GetScore(Mover) - Rules.GetScore(1 - Mover)));
+	}
+
+	HandStart = Pending.size();
+	++Hand;
+	Ply = 0;
+}
+
+void	TrainingRecorder::OnMove		(const Engine &Rules, Uint8 Level, Uint8 Move)
+{
+	TrainingRecord	Entry;
+	GameState		State;
+	Uint8			Current = Rules.GetCurrent();
+	const Player	&Mover = Rules.GetPlayer(Current);
+	Uint16			Legal = 0;
+
+	if (Log == 0)
+		return;
+
+	memset(Entry.Bytes, 0, TRAINING_RECORD_SIZE);
+
+	Rules.Pack(State);
+	PutState(Entry.Bytes + FIELD_STATE, State);
+
+	// Safeties can't be discarded
+	for (int i = 0; i < HAND_SIZE; ++i)
+	{
+		Uint8	Value = Mover.GetValue(i);
+
+		if (Value >= CARD_NULL_NULL)
+			continue;
+
+		if (Rules.IsValidPlay(i))
+			Legal |= 1 << i;
+		if (Card::GetTypeFromValue(Value) != CARD_SAFETY)
+			Legal |= 1 << (DISCARD_OFFSET + i);
+	}
+
+	Entry.Bytes[FIELD_PLAYER] = Current;
+	Entry.Bytes[FIELD_LEVEL] = Level;
+	Entry.Bytes[FIELD_MOVE] = Move;
+	Entry.Bytes[FIELD_OUTCOME] = OUTCOME_NOT_OVER;
+	PutUint16(Entry.Bytes + FIELD_LEGAL, Legal);
+	Entry.Bytes[FIELD_PLY] = Ply;
+	Entry.Bytes[FIELD_HAND] = Hand;
+	PutUint32(Entry.Bytes + FIELD_GAME, (Uint32) Rules.GetSeed());
+
+	Pending.push_back(Entry);
+	++Ply;
+}
+
+void	TrainingRecorder::SetLog		(TrainingLog *NewLog)
+{
+	Log = NewLog;
+}
+
+/* Private methods */
+
+void	TrainingLog::WriterMain		(void *Data)
+{
+	TrainingLog	&Self = *((TrainingLog *) Data);
+
+	for (;;)
+	{
+		TrainingBlock	*Block = 0;
+		bool			Done;
+
+		Self.Lock.Lock();
+		if (!Self.Full.empty())
+		{
+			Block = Self.Full.front();
+			Self.Full.pop_front();
+		}
+		Done = Self.Stopping;
+		Self.Lock.Unlock();
+
+		if (Block == 0)
+		{
+			if (Done)
+				break;
+
+			Thread::Sleep(1);
+			continue;
+		}
+
+		// After a failed write the rest are dropped
+		if (!Self.Failed && (fwrite(Block->Bytes, TRAINING_RECORD_SIZE, Block->Count, Self.File) != Block->Count))
+			Self.Failed = true;
+
+		Self.Lock.Lock();
+		if (!Self.Failed)
+			Self.Records += Block->Count;
+		Self.Free.push_back(Block);
+		Self.Lock.Unlock();
+	}
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_TRAINING_H
+#define	_SDLMILLE_TRAINING_H
+
+#include "Engine.h"
+#include "Thread.h"
+#include <deque>
+#include <stdio.h>
+#include <vector>
+
+namespace _SDLMille
+{
+
+const	Uint32	TRAINING_HEADER_SIZE = 128,
+				TRAINING_RECORD_SIZE = 64,
+				TRAINING_BLOCK_RECORDS = 4096,	// Records handed to the writer at a time
+				TRAINING_BLOCK_MAX = 64;		// Blocks in memory at once, full or filling
+
+/*	One record per move a computer player chose, written whole once the game is over so it
+	can carry how the hand and the game turned out. Every field is little-endian:
+
+	 0	the position the move was chosen in, as GameState packs it: for each player the
+		tableau (mileage pile counts in nibbles, limit, old limit, top and old top cards,
+		safeties with Coup Fourres in the high nibble), the seven cards in hand and the
+		qualified Coup Fourre, then ExposedCards in nibbles, cards left, current player,
+		top of the discard pile and the flags (46 bytes). Opponent's hand included, so
+		PositionEvaluator::GetFeatures gives the evaluator's inputs for either side.
+	46	both running scores, 16 bits each
+	50	the player who moved, and their difficulty
+	52	the move (0-6 play that slot, 7-13 discard it)
+	53	the game's outcome for the player who moved (won, drawn, lost)
+	54	the legal moves, one bit per move
+	56	the hand score margin, the mover's score less the opponent's, 16 bits
+	58	the move's number within the hand, and the hand's within the game
+	60	the low 32 bits of the game's seed
+
+	The file begins with a 128-byte header: "MTR1", the header size, the record size, then
+	the field list as text. Records follow back to back, so a trainer can map the file and
+	index it as an array. Opening an existing file appends to it, if its header matches. */
+
+struct TrainingRecord
+{
+	Uint8		Bytes[TRAINING_RECORD_SIZE];
+};
+
+struct TrainingBlock
+{
+	Uint8		Bytes[TRAINING_BLOCK_RECORDS * TRAINING_RECORD_SIZE];
+	Uint32		Count;
+};
+
+/*	The file and the thread that writes it. Recorders fill blocks and hand them over with
+	Submit, and the writer thread puts them on disk, so a worker never waits on the disk
+	unless the disk falls a whole TRAINING_BLOCK_MAX blocks behind, and memory stays the
+	same however many records go by. */
+
+class TrainingLog
+{
+public:
+				TrainingLog		(void);
+				~TrainingLog	(void);
+	TrainingBlock *	Acquire		(void);
+	bool		Close			(void);
+	Uint64		GetRecords		(void)					const;
+	bool		IsOpen			(void)					const;
+	bool		Open			(const char *Path);
+	void		Submit			(TrainingBlock *Block);
+private:
+				TrainingLog		(const TrainingLog &);
+	TrainingLog &	operator=	(const TrainingLog &);
+
+	static	void	WriterMain	(void *Data);
+
+	std::vector<TrainingBlock *>	Blocks,	// Every block, to free at the end
+									Free;
+	std::deque<TrainingBlock *>		Full;
+	FILE		*File;
+	Mutex		Lock;
+	Thread		Writer;
+	Uint64		Records;
+	bool		Failed,
+				Stopping;
+};
+
+/*	One per thread playing games; the Simulator tells it about each move, the end of each
+	hand and the end of the game. Records wait here until the game ends, then go into the
+	current block. Flush before closing the log hands over the last, partly filled block. */
+
+class TrainingRecorder
+{
+public:
+				TrainingRecorder	(void);
+	void		Abandon			(void);
+	void		Flush			(void);
+	void		OnGameOver		(Uint8 Outcome);
+	void		OnHandOver		(const Engine &Rules);
+	void		OnMove			(const Engine &Rules, Uint8 Level, Uint8 Move);
+	void		SetLog			(TrainingLog *NewLog);
+private:
+	TrainingLog	*Log;
+	TrainingBlock	*Block;
+	std::vector<TrainingRecord>	Pending;	// This game's records
+	Uint32		HandStart;	// First of Pending in the current hand
+	Uint8		Hand,
+				Ply;
+};
+
+inline	Uint64	TrainingLog::GetRecords		(void)			const
+{
+	return Records;
+}
+
+inline	bool	TrainingLog::IsOpen			(void)			const
+{
+	return File != 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#include "Tuner.h"
+#include <math.h>
+
+namespace _SDLMille
+{
+
+		Tuner::Tuner			(void)
+{
+	BestScore = 0;
+	BestGeneration = 0;
+	Generation = 0;
+	Milliseconds = 0;
+	Level = DIFFICULTY_HARD;
+	Size = 0;
+
+	for (int i = 0; i < TUNER_POPULATION_MAX; ++i)
+		Fitness[i] = 0;
+}
+
+void	Tuner::Start			(const WeightTable &Initial, Uint8 NewSize, Uint8 NewLevel, Uint64 NewSeed)
+{
+	// The starting table is kept as it is, and the rest of the population spreads out around it
+	Size = std::max((Uint8) 2, std::min(NewSize, TUNER_POPULATION_MAX));
+	Level = NewLevel;
+	Generator.Seed(NewSeed);
+	Generation = 0;
+	Milliseconds = 0;
+	Best = Initial;
+	BestScore = 0;
+	BestGeneration = 0;
+
+	for (int i = 0; i < Size; ++i)
+	{
+		Population[i] = Initial;
+		Fitness[i] = 0;
+
+		if (i > 0)
+			Mutate(Population[i]);
+	}
+}
+
+bool	Tuner::Step				(Uint32 GamesPerCandidate, Uint8 ThreadCount)
+{
+	Tournament	Games;
+	Uint8		Ranking[TUNER_POPULATION_MAX];
+	double		Defending = 0;
+
+	if (Size == 0)
+		return false;
+
+	Games.AddPolicy(Level);
+
+	for (int i = 0; i < Size; ++i)
+		Games.AddPolicy(Level, &Population[i]);
+
+	Games.AddPolicy(Level, &Best);
+
+	if (!Games.Run(GamesPerCandidate, ThreadCount, Generator.Next(), true))
+		return false;
+
+	Milliseconds = Games.GetMilliseconds();
+
+	for (int i = 0; i <= Size; ++i)
+	{
+		const TournamentResult	&Result = Games.GetResult(i);
+		double					Margin = (Result.Hands > 0) ? (Result.ScoreTotals[0] - Result.ScoreTotals[1]) / Result.Hands : 0;
+
+		if (Result.Errors > 0)
+			return false;
+
+		if (i == Size)
+		{
+			Defending = Margin;
+			break;
+		}
+
+		Fitness[i] = Margin;
+		Ranking[i] = i;
+	}
+
+	// Best first
+	for (int i = 1; i < Size; ++i)
+	{
+		for (int j = i; (j > 0) && (Fitness[Ranking[j]] > Fitness[Ranking[j - 1]]); --j)
+			std::swap(Ranking[j], Ranking[j - 1]);
+	}
+
+	++Generation;
+
+	// Scores are only compared on the deals both tables played
+	if (Fitness[Ranking[0]] > Defending)
+	{
+		Best = Population[Ranking[0]];
+		BestScore = Fitness[Ranking[0]];
+		BestGeneration = Generation;
+	}
+	else
+		BestScore = Defending;
+
+	Breed(Ranking);
+
+	return true;
+}
+
+/* Private methods */
+
+void	Tuner::Breed			(const Uint8 *Ranking)
+{
+	WeightTable	Next[TUNER_POPULATION_MAX];
+	Uint8		Elite = std::max(1, std::min((int) TUNER_ELITE_MAX, Size / 4));
+
+	for (int i = 0; i < Elite; ++i)
+		Next[i] = Population[Ranking[i]];
+
+	for (int i = Elite; i < Size; ++i)
+	{
+		const WeightTable	&Mother = Population[Pick(Ranking)],
+							&Father = Population[Pick(Ranking)];
+
+		for (int j = 0; j < WEIGHT_COUNT; ++j)
+			Next[i].Set(j, (Generator.Next() & 1) ? Mother.Get(j) : Father.Get(j));
+
+		Mutate(Next[i]);
+	}
+
+	for (int i = 0; i < Size; ++i)
+		Population[i] = Next[i];
+}
+
+double	Tuner::Gaussian			(void)
+{
+	// Box-Muller, from two uniforms in (0, 1]
+	double	First = ((Generator.Next() >> 11) + 1) * (1.0 / 9007199254740992.0),
+			Second = ((Generator.Next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+
+	return sqrt(-2 * log(First)) * cos(6.283185307179586 * Second);
+}
+
+void	Tuner::Mutate			(WeightTable &Table)
+{
+	// Each weight moves with a one in four chance, by a step that scales with its size
+	for (int i = 0; i < WEIGHT_COUNT; ++i)
+	{
+		if (Generator.Below(4) == 0)
+		{
+			int		Value = Table.Get(i);
+			double	Step = std::max(2.0, fabs((double) Value) / 5);
+
+			Table.Set(i, Value + (int) floor(Gaussian() * Step + 0.5));
+		}
+	}
+}
+
+Uint8	Tuner::Pick				(const Uint8 *Ranking)
+{
+	// A binary tournament among the better half
+	Uint8	Half = std::max(1, Size / 2),
+			First = Generator.Below(Half),
+			Second = Generator.Below(Half);
+
+	return Ranking[std::min(First, Second)];
+}
+
+}
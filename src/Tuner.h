@@ -0,0 +1,99 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_TUNER_H
+#define	_SDLMILLE_TUNER_H
+
+#include "Tournament.h"
+
+namespace _SDLMille
+{
+
+const	Uint8	TUNER_POPULATION_MAX = TOURNAMENT_POLICY_MAX - 2,	// The baseline and the best table so far take two places
+				TUNER_ELITE_MAX = 4;
+
+/*	Tunes ComputerSmartMove's weights with a genetic algorithm. Each generation plays every
+	candidate table against a fixed baseline (the default weights at the same difficulty) in
+	a gauntlet, so all candidates see the same deals, and scores them by their average hand
+	score margin. The best few carry over unchanged and are played again on fresh deals, so a
+	lucky table can't stay on top for long; the rest of the next generation is bred from the
+	better half by uniform crossover and Gaussian mutation.
+
+	The best table so far plays every generation's deals alongside the candidates, and a
+	candidate only takes its place by beating it on those same deals. A later generation
+	dealt harder hands can't replace a better table found earlier. */
+
+class Tuner
+{
+public:
+				Tuner			(void);
+	const WeightTable &	GetBest	(void)						const;
+	Uint32		GetBestGeneration	(void)					const;
+	double		GetBestScore	(void)						const;
+	Uint32		GetGeneration	(void)						const;
+	Uint32		GetMilliseconds	(void)						const;
+	void		Start			(const WeightTable &Initial, Uint8 Size, Uint8 NewLevel, Uint64 NewSeed);
+	bool		Step			(Uint32 GamesPerCandidate, Uint8 ThreadCount);
+private:
+	void		Breed			(const Uint8 *Ranking);
+	double		Gaussian		(void);
+	void		Mutate			(WeightTable &Table);
+	Uint8		Pick			(const Uint8 *Ranking);
+
+	WeightTable	Best,
+				Population[TUNER_POPULATION_MAX];
+	double		BestScore,
+				Fitness[TUNER_POPULATION_MAX];
+	Random		Generator;
+	Uint32		BestGeneration,
+				Generation,
+				Milliseconds;
+	Uint8		Level,
+				Size;
+};
+
+inline	const WeightTable &	Tuner::GetBest	(void)			const
+{
+	return Best;
+}
+
+inline	Uint32	Tuner::GetBestGeneration	(void)			const
+{
+	return BestGeneration;
+}
+
+inline	double	Tuner::GetBestScore		(void)				const
+{
+	return BestScore;
+}
+
+inline	Uint32	Tuner::GetGeneration	(void)				const
+{
+	return Generation;
+}
+
+inline	Uint32	Tuner::GetMilliseconds	(void)				const
+{
+	return Milliseconds;
+}
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+#ifndef _SDLMILLE_TYPES_H
+#define	_SDLMILLE_TYPES_H
+
+/*	Fixed-width integer types used by the rules engine. These are the same typedefs SDL
+	declares, so the engine builds without SDL (see millesim) and still links cleanly
+	against the graphical game. */
+
+#include <stdint.h>
+
+typedef	int8_t		Sint8;
+typedef	uint8_t		Uint8;
+typedef	int16_t		Sint16;
+typedef	uint16_t	Uint16;
+typedef	int32_t		Sint32;
+typedef	uint32_t	Uint32;
+typedef	uint64_t	Uint64;
+
+namespace _SDLMille
+{
+
+/*	Packed states (see GameState.h) store small counts two to a byte. */
+
+inline	Uint8	GetNibble	(const Uint8 *Packed, int Index)
+{
+	return (Packed[Index >> 1] >> ((Index & 1) << 2)) & 0x0F;
+}
+
+inline	void	SetNibble	(Uint8 *Packed, int Index, Uint8 Value)
+{
+	Uint8	Shift = (Index & 1) << 2;
+
+	Packed[Index >> 1] = (Packed[Index >> 1] & ~(0x0F << Shift)) | ((Value & 0x0F) << Shift);
+}
+
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#include "Weights.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace _SDLMille
+{
+
+namespace
+{
+
+// Built before main, so threads never race to construct it
+const	WeightTable	Defaults;
+
+}
+
+		WeightTable::WeightTable	(void)
+{
+	Reset();
+}
+
+const WeightTable &	WeightTable::GetDefault	(void)
+{
+	return Defaults;
+}
+
+bool	WeightTable::Load		(const char *Path)
+{
+	FILE	*WeightFile = fopen(Path, "r");
+	char	Name[WEIGHT_NAME_SIZE + 1];
+	int		Value;
+
+	if (WeightFile == 0)
+		return false;
+
+	while (fscanf(WeightFile, "%32s %d", Name, &Value) == 2)
+	{
+		for (int i = 0; i < WEIGHT_COUNT; ++i)
+		{
+			if (strcmp(Name, WEIGHT_NAMES[i]) == 0)
+			{
+				Values[i] = Value;
+				break;
+			}
+		}
+	}
+
+	fclose(WeightFile);
+	Refingerprint();
+
+	return true;
+}
+
+void	WeightTable::Reset		(void)
+{
+	for (int i = 0; i < WEIGHT_COUNT; ++i)
+		Values[i] = DEFAULT_WEIGHTS[i];
+
+	Refingerprint();
+}
+
+bool	WeightTable::Save		(const char *Path)		const
+{
+	FILE	*WeightFile = fopen(Path, "w");
+
+	if (WeightFile == 0)
+		return false;
+
+	for (int i = 0; i < WEIGHT_COUNT; ++i)
+		fprintf(WeightFile, "%s %d\n", WEIGHT_NAMES[i], Values[i]);
+
+	fclose(WeightFile);
+
+	return true;
+}
+
+void	WeightTable::Set		(Uint8 Index, int Value)
+{
+	if (Index < WEIGHT_COUNT)
+	{
+		Values[Index] = Value;
+		Refingerprint();
+	}
+}
+
+/* Private methods */
+
+void	WeightTable::Refingerprint	(void)
+{
+	// FNV-1a over the values, a byte at a time from the low end so it's the same on any machine
+	Fingerprint = 2166136261U;
+
+	for (int i = 0; i < WEIGHT_COUNT; ++i)
+	{
+		Uint32	Value = Values[i];
+
+		for (int j = 0; j < 4; ++j)
+			Fingerprint = (Fingerprint ^ ((Value >> (j * 8)) & 0xFF)) * 16777619U;
+	}
+}
+
+}
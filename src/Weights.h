@@ -0,0 +1,121 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_WEIGHTS_H
+#define	_SDLMILLE_WEIGHTS_H
+
+#include "Types.h"
+
+namespace _SDLMille
+{
+
+/*	The weights ComputerSmartMove gives each card, one per rule. A rule's ID (A00 for
+	safeties, B for remedies, C for hazards, D for mileage, E for reading the opponent) starts
+	its name. Weights marked "per" are multiplied by a count rather than added once. */
+
+enum	{	WEIGHT_A00_COUP_FOURRE = 0, WEIGHT_A10_GAME_ALMOST_OVER, WEIGHT_A20_LAST_CARDS, WEIGHT_A30_ROW_NO_HAZARDS,
+			WEIGHT_A40_ROW_TO_ROLL, WEIGHT_A50_ROW_TO_UNLIMIT, WEIGHT_A52_ROW_NO_ROLLS, WEIGHT_A54_ROW_NO_END_LIMITS,
+			WEIGHT_A60_NO_HAZARDS, WEIGHT_A70_OUT_OF_JAM,
+			WEIGHT_B00_HAVE_SAFETY, WEIGHT_B03_ROLL, WEIGHT_B06_TOO_MANY_ROLLS, WEIGHT_B09_ROLL_WITH_ROW,
+			WEIGHT_B12_ROLL, WEIGHT_B20_CURRENT_HAZARD, WEIGHT_B30_NOT_NEEDED, WEIGHT_B40_GENERAL,
+			WEIGHT_B42_DUPLICATE, WEIGHT_B44_ALMOST_GONE, WEIGHT_B46_PER_KNOWN_HAZARD,
+			WEIGHT_C00_OPPONENT_SAFE, WEIGHT_C06_SHUTOUT_RISK, WEIGHT_C10_MUST_STOP, WEIGHT_C20_GENERAL,
+			WEIGHT_C20_PER_KNOWN_REMEDY, WEIGHT_C30_NO_REMEDY, WEIGHT_C40_NO_SAFETY, WEIGHT_C50_LIMIT_ROLLING,
+			WEIGHT_D00_PAST_END, WEIGHT_D00_PAST_END_EXTENDED, WEIGHT_D03_NO_200S_LEFT, WEIGHT_D06_SPARE_200S,
+			WEIGHT_D09_DEFER_200, WEIGHT_D12_FINISH_WITH_200, WEIGHT_D15_200_LEAVES_25, WEIGHT_D18_200_CATCH_UP,
+			WEIGHT_D21_200, WEIGHT_D30_FINISH, WEIGHT_D35_PAIR_FINISHES, WEIGHT_D36_PAIR_FINISHES,
+			WEIGHT_D40_LEAVES_100, WEIGHT_D43_LEAVES_75, WEIGHT_D46_LEAVES_50, WEIGHT_D48_LEAVES_25,
+			WEIGHT_D60_NEARING_END, WEIGHT_D80_PER_25_MILES,
+			WEIGHT_E00_BELIEF_THRESHOLD,
+			WEIGHT_COUNT	};
+
+const	Uint8	WEIGHT_NAME_SIZE = 32;
+
+const	char	WEIGHT_NAMES[WEIGHT_COUNT][WEIGHT_NAME_SIZE] = {
+					"A00_COUP_FOURRE", "A10_GAME_ALMOST_OVER", "A20_LAST_CARDS", "A30_ROW_NO_HAZARDS",
+					"A40_ROW_TO_ROLL", "A50_ROW_TO_UNLIMIT", "A52_ROW_NO_ROLLS", "A54_ROW_NO_END_LIMITS",
+					"A60_NO_HAZARDS", "A70_OUT_OF_JAM",
+					"B00_HAVE_SAFETY", "B03_ROLL", "B06_TOO_MANY_ROLLS", "B09_ROLL_WITH_ROW",
+					"B12_ROLL", "B20_CURRENT_HAZARD", "B30_NOT_NEEDED", "B40_GENERAL",
+					"B42_DUPLICATE", "B44_ALMOST_GONE", "B46_PER_KNOWN_HAZARD",
+					"C00_OPPONENT_SAFE", "C06_SHUTOUT_RISK", "C10_MUST_STOP", "C20_GENERAL",
+					"C20_PER_KNOWN_REMEDY", "C30_NO_REMEDY", "C40_NO_SAFETY", "C50_LIMIT_ROLLING",
+					"D00_PAST_END", "D00_PAST_END_EXTENDED", "D03_NO_200S_LEFT", "D06_SPARE_200S",
+					"D09_DEFER_200", "D12_FINISH_WITH_200", "D15_200_LEAVES_25", "D18_200_CATCH_UP",
+					"D21_200", "D30_FINISH", "D35_PAIR_FINISHES", "D36_PAIR_FINISHES",
+					"D40_LEAVES_100", "D43_LEAVES_75", "D46_LEAVES_50", "D48_LEAVES_25",
+					"D60_NEARING_END", "D80_PER_25_MILES",
+					"E00_BELIEF_THRESHOLD"	},
+				WEIGHT_FILE[] = "weights.txt";
+
+// The hand-tuned values the game shipped with. E00 came later; at 0 it changes nothing until a tuned table sets it
+const	int		DEFAULT_WEIGHTS[WEIGHT_COUNT] = {
+					100, 95, 90, 50,
+					60, 60, 60, 60,
+					50, 60,
+					-100, 50, -100, 20,
+					40, 50, -100, 30,
+					-10, 10, -1,
+					-100, -50, 60, 40,
+					1, 10, 15, -5,
+					-50, -100, -100, -100,
+					5, 90, 5, 48,
+					6, 90, 50, 50,
+					35, 25, 15, -25,
+					20, 6,
+					0	};
+
+/*	A full set of weights. Tables are loaded from and saved to text files with one
+	"NAME value" line per weight; names that are missing keep their current value, so an
+	old file still loads after new weights are added. */
+
+class WeightTable
+{
+public:
+				WeightTable		(void);
+	int			Get				(Uint8 Index)					const;
+	Uint32		GetFingerprint	(void)							const;
+	bool		Load			(const char *Path);
+	void		Reset			(void);
+	bool		Save			(const char *Path)				const;
+	void		Set				(Uint8 Index, int Value);
+
+	static	const WeightTable &	GetDefault	(void);
+private:
+	/* Methods */
+	void		Refingerprint	(void);
+
+	/* Properties */
+	int			Values[WEIGHT_COUNT];
+	Uint32		Fingerprint;	// Hash of Values, so tables can be told apart cheaply
+};
+
+inline	int		WeightTable::Get		(Uint8 Index)			const
+{
+	return Values[Index];
+}
+
+inline	Uint32	WeightTable::GetFingerprint	(void)				const
+{
+	return Fingerprint;
+}
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+#ifndef _SDLMILLE_ZOBRIST_H
+#define	_SDLMILLE_ZOBRIST_H
+
+#include "Deck.h"
+
+namespace _SDLMille
+{
+
+/*	Zobrist keys for hashing positions. Each feature of a position (a card value in a hand, a
+	pile count, a top card, a safety, the side to move...) has its own random 64-bit key, and a
+	position's hash combines the keys of everything in it. Hand and Tableau keep their part up
+	to date as cards move, so Engine::GetHash costs the same however the position was reached.
+
+	Hands are multisets, so their keys are added rather than XORed: two copies of a card add
+	two keys instead of cancelling out. Everything else is XORed in and out.
+
+	The keys are SplitMix64 of the feature's index, computed when needed rather than stored,
+	so there's no table to initialise before the first Tableau is built. */
+
+const	Uint32	ZOBRIST_BLOCK = 32;	// Room for every card value, including CARD_NULL_NULL
+
+enum	{	ZOBRIST_HAND = 0,
+			ZOBRIST_PILE = ZOBRIST_HAND + ZOBRIST_BLOCK,					// Pile * ZOBRIST_BLOCK + count
+			ZOBRIST_TOP_CARD = ZOBRIST_PILE + ZOBRIST_BLOCK * ZOBRIST_BLOCK,
+			ZOBRIST_OLD_TOP_CARD = ZOBRIST_TOP_CARD + ZOBRIST_BLOCK,
+			ZOBRIST_LIMIT_CARD = ZOBRIST_OLD_TOP_CARD + ZOBRIST_BLOCK,
+			ZOBRIST_OLD_LIMIT_CARD = ZOBRIST_LIMIT_CARD + ZOBRIST_BLOCK,
+			ZOBRIST_SAFETY = ZOBRIST_OLD_LIMIT_CARD + ZOBRIST_BLOCK,
+			ZOBRIST_COUP_FOURRE = ZOBRIST_SAFETY + ZOBRIST_BLOCK,
+			ZOBRIST_QUALIFIED = ZOBRIST_COUP_FOURRE + ZOBRIST_BLOCK,		// Hazard a Coup Fourre would answer
+			ZOBRIST_CARDS_LEFT = ZOBRIST_QUALIFIED + ZOBRIST_BLOCK,
+			ZOBRIST_CURRENT = ZOBRIST_CARDS_LEFT + DECK_SIZE + 1,
+			ZOBRIST_EXTENDED,
+			ZOBRIST_EXTENSION_DECLINED	};
+
+inline	Uint64	GetZobristKey	(Uint32 Index)
+{
+	Uint64	Result = (Index + 1) * 0x9E3779B97F4A7C15ULL;
+
+	Result = (Result ^ (Result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	Result = (Result ^ (Result >> 27)) * 0x94D049BB133111EBULL;
+
+	return Result ^ (Result >> 31);
+}
+
+inline	Uint64	GetZobristCardKey	(Uint32 Offset, Uint8 Value)
+{
+	// Card values past the end (an empty slot, or 0xFF for no card at all) share one key
+	return GetZobristKey(Offset + ((Value < CARD_NULL_NULL) ? Value : (Uint8) CARD_NULL_NULL));
+}
+
+}
+
+#endif
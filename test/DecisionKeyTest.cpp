@@ -0,0 +1,88 @@
+/*
+This file is part of SDL Mille.
+
+SDL Mille is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SDL Mille is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SDL Mille.  If not, see <http://www.gnu.org/licenses/>.
+
+(See file LICENSE for full text of license)
+*/
+
+
+
+#include "Engine.h"
+#include <stdio.h>
+#include <string.h>
+
+/*	Checks that the decision cache's key tells apart positions that ComputerWeighMove plays
+	differently. Build it from this directory against the files in ../src (see README); it
+	prints each check and exits with 1 if any failed. */
+
+using namespace _SDLMille;
+
+namespace
+{
+
+class KeyProbe : public Engine
+{
+public:
+	explicit	KeyProbe		(Uint64 Seed) : Engine(Seed)	{}
+	void		GetKey			(DecisionKey &Key)	const		{ GetDecisionKey(Key); }
+	Tableau &	GetTableau		(Uint8 PlayerIndex)				{ return Players[PlayerIndex].GetTableau(); }
+};
+
+bool	Check		(const char *Name, bool Passed)
+{
+	printf("%s: %s\n", Passed ? "pass" : "FAIL", Name);
+
+	return Passed;
+}
+
+bool	CheckOpponent200s	(void)
+{
+	// 200 miles from one card or from two 100s: only the opponent's 200 count differs
+	KeyProbe	One(1), Two(1);
+	DecisionKey	OneKey, TwoKey;
+	Uint8		Opponent = 1 - One.GetCurrent();
+
+	One.GetTableau(Opponent).OnPlay(CARD_MILEAGE_200, false, false);
+	Two.GetTableau(Opponent).OnPlay(CARD_MILEAGE_100, false, false);
+	Two.GetTableau(Opponent).OnPlay(CARD_MILEAGE_100, false, false);
+
+	One.GetKey(OneKey);
+	Two.GetKey(TwoKey);
+
+	return Check("opponent's 200-mile count is in the key", memcmp(OneKey.Bytes, TwoKey.Bytes, DECISION_KEY_SIZE) != 0);
+}
+
+bool	CheckSamePosition	(void)
+{
+	KeyProbe	One(1), Two(1);
+	DecisionKey	OneKey, TwoKey;
+
+	One.GetKey(OneKey);
+	Two.GetKey(TwoKey);
+
+	return Check("the same position gives the same key", memcmp(OneKey.Bytes, TwoKey.Bytes, DECISION_KEY_SIZE) == 0);
+}
+
+}
+
+int		main		(int, char **)
+{
+	bool	Passed = true;
+
+	Passed &= CheckSamePosition();
+	Passed &= CheckOpponent200s();
+
+	return Passed ? 0 : 1;
+}